@@ -0,0 +1,178 @@
+/* file: bench/shm_contention.c */
+// Write-contention benchmark for the shared gang state. Each writer thread
+// owns one gang and repeats the writes a gang process makes (member prep
+// levels, queue high-water marks, the odd scoreboard bump) while one
+// reader sweeps every gang the way police and GUI do. Both layouts get
+// the very same relaxed atomic stores and loads; only where the fields
+// live differs: packed parallel MAX_GANGS arrays (the old layout) or
+// shm_layout_t's cache-line-aligned per-gang blocks. The ratio is what
+// false sharing between neighbouring gangs costs.
+// Usage: bench/shm_contention [writers] [seconds]
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include "../ipc_utils.h"
+
+// the gang and score regions of shm_layout_t before the per-gang blocks
+typedef struct
+{
+    scoreboard_t score;
+    gang_state_t gang[MAX_GANGS];
+    _Atomic double suspicion[MAX_GANGS];
+    _Atomic int gang_prep_levels[MAX_GANGS][MAX_MEMBERS_PER_GANG];
+    _Atomic uint32_t queue_hwm[MAX_GANGS][MAX_MEMBERS_PER_GANG];
+} old_layout_t;
+
+typedef enum { LAYOUT_OLD, LAYOUT_PER_GANG } layout_t;
+
+typedef struct
+{
+    layout_t layout;
+    void *mem;
+    int writers;
+    _Atomic int stop;
+    uint64_t writes[MAX_GANGS];
+    uint64_t sweeps;
+} bench_t;
+
+typedef struct
+{
+    bench_t *b;
+    int gang;
+} writer_arg_t;
+
+// members per gang the writers cycle through, as in a typical config
+#define BENCH_MEMBERS 8
+// one scoreboard update per this many member writes
+#define BENCH_SCORE_EVERY 64
+
+// where gang g's fields live in either layout
+typedef struct
+{
+    _Atomic int *prep_levels;
+    _Atomic uint32_t *queue_hwm;
+    _Atomic uint32_t *members_alive;
+    _Atomic double *suspicion;
+    _Atomic uint32_t *plans_success;
+} gang_fields_t;
+
+static gang_fields_t fields(const bench_t *b, int g)
+{
+    if (b->layout == LAYOUT_OLD)
+    {
+        old_layout_t *o = b->mem;
+        return (gang_fields_t){o->gang_prep_levels[g], o->queue_hwm[g], &o->gang[g].members_alive,
+                               &o->suspicion[g], &o->score.plans_success};
+    }
+    shm_layout_t *shm = b->mem;
+    gang_shm_t *pg = &shm->per_gang[g];
+    return (gang_fields_t){pg->prep_levels, pg->queue_hwm, &pg->state.members_alive,
+                           &pg->suspicion, &shm->score.plans_success};
+}
+
+static void *writer(void *arg)
+{
+    writer_arg_t *wa = arg;
+    bench_t *b = wa->b;
+    gang_fields_t f = fields(b, wa->gang);
+    uint64_t n = 0;
+
+    while (!atomic_load_explicit(&b->stop, memory_order_relaxed))
+    {
+        int m = (int)(n % BENCH_MEMBERS);
+        SHM_STORE(&f.prep_levels[m], (int)(n & 3));
+        SHM_STORE(&f.queue_hwm[m], (uint32_t)n);
+        if (n % BENCH_SCORE_EVERY == 0)
+            SHM_ADD(f.plans_success, 1);
+        n++;
+    }
+    b->writes[wa->gang] = n;
+    return NULL;
+}
+
+static void *reader(void *arg)
+{
+    bench_t *b = arg;
+    uint64_t sweeps = 0;
+    volatile int sink = 0;
+
+    while (!atomic_load_explicit(&b->stop, memory_order_relaxed))
+    {
+        for (int g = 0; g < b->writers; g++)
+        {
+            gang_fields_t f = fields(b, g);
+            int sum = (int)SHM_LOAD(f.members_alive) + (int)SHM_LOAD(f.suspicion);
+            for (int m = 0; m < BENCH_MEMBERS; m++)
+                sum += SHM_LOAD(&f.prep_levels[m]);
+            sink += sum;
+        }
+        sweeps++;
+    }
+    b->sweeps = sweeps;
+    return NULL;
+}
+
+static int run(layout_t layout, int writers, int seconds, double *writes_per_s)
+{
+    size_t bytes = layout == LAYOUT_OLD ? sizeof(old_layout_t) : sizeof(shm_layout_t);
+    void *mem = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED)
+    {
+        perror("mmap");
+        return -1;
+    }
+
+    bench_t b = { .layout = layout, .mem = mem, .writers = writers };
+    writer_arg_t args[MAX_GANGS];
+    pthread_t wthr[MAX_GANGS], rthr;
+
+    for (int g = 0; g < writers; g++)
+    {
+        args[g] = (writer_arg_t){ .b = &b, .gang = g };
+        pthread_create(&wthr[g], NULL, writer, &args[g]);
+    }
+    pthread_create(&rthr, NULL, reader, &b);
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    sleep((unsigned)seconds);
+    atomic_store(&b.stop, 1);
+    for (int g = 0; g < writers; g++)
+        pthread_join(wthr[g], NULL);
+    pthread_join(rthr, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    double elapsed = (double)(sim_ts_ns(&t1) - sim_ts_ns(&t0)) / 1e9;
+    uint64_t total = 0;
+    for (int g = 0; g < writers; g++)
+        total += b.writes[g];
+    *writes_per_s = (double)total / elapsed;
+
+    printf("%-9s %3d writers: %8.2f M writes/s, %8.0f reader sweeps/s\n",
+           layout == LAYOUT_OLD ? "old" : "per-gang", writers, *writes_per_s / 1e6,
+           (double)b.sweeps / elapsed);
+
+    munmap(mem, bytes);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int writers = argc > 1 ? atoi(argv[1]) : 4;
+    int seconds = argc > 2 ? atoi(argv[2]) : 2;
+    if (writers < 1 || writers > MAX_GANGS || seconds < 1)
+    {
+        fprintf(stderr, "usage: %s [writers 1..%d] [seconds]\n", argv[0], MAX_GANGS);
+        return EXIT_FAILURE;
+    }
+
+    double old_rate, new_rate;
+    if (run(LAYOUT_OLD, writers, seconds, &old_rate) == -1 ||
+        run(LAYOUT_PER_GANG, writers, seconds, &new_rate) == -1)
+        return EXIT_FAILURE;
+    printf("per-gang / old (false sharing removed): %.2fx\n", new_rate / old_rate);
+    return 0;
+}
@@ -64,6 +64,8 @@ int load_config_json(const char *path)
         return -1;
     }
 
+    cfg.police_enabled = 1; // unless the file turns it off
+
     /* Iterate all string tokens and assign config values */
     for (int i = 1; i < ntok; i++)
     {
@@ -123,12 +125,53 @@ int load_config_json(const char *path)
             cfg.max_simulation_runtime_s = atoi(val);
         else if (tok_eq(json, &tokens[i], "report_batch_size"))
             cfg.report_batch_size = atoi(val);
+        else if (tok_eq(json, &tokens[i], "report_flush_ms"))
+            cfg.report_flush_ms = atoi(val);
+        else if (tok_eq(json, &tokens[i], "report_queue_depth"))
+            cfg.report_queue_depth = atoi(val);
         else if (tok_eq(json, &tokens[i], "send_prob"))
             cfg.send_prob = atof(val); // Added by Talin SAT
         else if (tok_eq(json, &tokens[i], "peer_prob"))
             cfg.peer_prob = atof(val); // Added by Talin SAT
         else if (tok_eq(json, &tokens[i], "num_missions"))
               cfg.num_missions = atoi(val);  // HALA: parse number of missions
+        else if (tok_eq(json, &tokens[i], "msg_queue_depth"))
+            cfg.msg_queue_depth = atoi(val);
+        else if (tok_eq(json, &tokens[i], "gangs_per_process"))
+            cfg.gangs_per_process = atoi(val);
+        else if (tok_eq(json, &tokens[i], "executor_workers"))
+            cfg.executor_workers = atoi(val);
+        else if (tok_eq(json, &tokens[i], "report_ring_slots"))
+            cfg.report_ring_slots = atoi(val);
+        else if (tok_eq(json, &tokens[i], "event_log_records"))
+            cfg.event_log_records = atoi(val);
+        else if (tok_eq(json, &tokens[i], "report_transport"))
+        {
+            if (tok_eq(json, &tokens[i + 1], "shm_ring"))
+                cfg.report_transport = TRANSPORT_SHM_RING;
+            else
+                cfg.report_transport = TRANSPORT_MQUEUE;
+        }
+        else if (tok_eq(json, &tokens[i], "clock_mode"))
+        {
+            if (tok_eq(json, &tokens[i + 1], "virtual"))
+                cfg.clock_mode = CLOCK_MODE_VIRTUAL;
+            else
+                cfg.clock_mode = CLOCK_MODE_REAL;
+        }
+        else if (tok_eq(json, &tokens[i], "time_scale"))
+            cfg.time_scale = atof(val);
+        else if (tok_eq(json, &tokens[i], "police_enabled"))
+            cfg.police_enabled = atoi(val);
+        else if (tok_eq(json, &tokens[i], "msg_queue_policy"))
+        {
+            if (tok_eq(json, &tokens[i + 1], "block"))
+                cfg.msg_queue_policy = QUEUE_BLOCK;
+            else if (tok_eq(json, &tokens[i + 1], "drop_oldest"))
+                cfg.msg_queue_policy = QUEUE_DROP_OLDEST;
+            else
+                cfg.msg_queue_policy = QUEUE_DROP_NEWEST;
+        }
 
     }
 
@@ -196,6 +239,16 @@ int load_crimes_json(const char *path)
     free(js);
     return -1;
 }
+const char *intel_text(const Config *c, intel_code_t code)
+{
+    int crime = INTEL_CODE_CRIME(code);
+    int idx = INTEL_CODE_IDX(code);
+    if (code == INTEL_CODE_NONE || crime >= c->num_crimes ||
+        idx >= c->crimes[crime].legit_prep_intel_count)
+        return "(unknown intel)";
+    return c->crimes[crime].legit_prep_intel[idx];
+}
+
 void print_config()
 {
     printf("=== Simulation Configuration ===\n");
@@ -225,6 +278,18 @@ void print_config()
     printf("status_update_interval_s: %d\n", cfg.status_update_interval_s);
     printf("max_simulation_runtime_s: %d\n", cfg.max_simulation_runtime_s);
     printf("report_batch_size: %d\n", cfg.report_batch_size);
+    printf("report_flush_ms: %d\n", cfg.report_flush_ms);
+    printf("report_queue_depth: %d\n", cfg.report_queue_depth);
+    printf("report_transport: %d\n", cfg.report_transport);
+    printf("report_ring_slots: %d\n", cfg.report_ring_slots);
+    printf("event_log_records: %d\n", cfg.event_log_records);
+    printf("msg_queue_depth: %d\n", cfg.msg_queue_depth);
+    printf("msg_queue_policy: %d\n", cfg.msg_queue_policy);
+    printf("gangs_per_process: %d\n", cfg.gangs_per_process);
+    printf("executor_workers: %d\n", cfg.executor_workers);
+    printf("clock_mode: %d\n", cfg.clock_mode);
+    printf("time_scale: %.2f\n", cfg.time_scale);
+    printf("police_enabled: %d\n", cfg.police_enabled);
 
     printf("num_crimes: %d\n", cfg.num_crimes);
     printf("num_missions: %d\n", cfg.num_missions);
@@ -3,11 +3,41 @@
 #define CONFIG_H
 
 #include <stddef.h>
+#include <stdint.h>
 #define MAX_CRIMES           10
 #define MAX_CRIME_NAME_LEN  128
 #define MAX_INTEL_ENTRIES    10
 #define MAX_INTEL_LEN       256
 
+/* Compact intel encoding: (crime_id, intel_idx) packed into one integer.
+ * Codes are fixed by the order of crimes.json, so every process derives
+ * the same code for a snippet and only the code crosses IPC. */
+typedef uint16_t intel_code_t;
+#define MAX_INTEL_CODES          (MAX_CRIMES * MAX_INTEL_ENTRIES)
+#define INTEL_CODE_NONE          ((intel_code_t)0xFFFF)
+#define INTEL_CODE(crime, idx)   ((intel_code_t)((crime) * MAX_INTEL_ENTRIES + (idx)))
+#define INTEL_CODE_CRIME(code)   ((int)(code) / MAX_INTEL_ENTRIES)
+#define INTEL_CODE_IDX(code)     ((int)(code) % MAX_INTEL_ENTRIES)
+
+/* What send_message() does when a member's queue is full */
+typedef enum {
+    QUEUE_DROP_NEWEST = 0,   // discard the message being sent (default)
+    QUEUE_DROP_OLDEST,       // evict the oldest unread message
+    QUEUE_BLOCK              // wait up to ipc_timeout_ms, then drop newest
+} queue_policy_t;
+
+/* How police reports and GUI notifications travel between processes */
+typedef enum {
+    TRANSPORT_MQUEUE = 0,    // POSIX message queue (default)
+    TRANSPORT_SHM_RING       // lock-free ring in its own shm segment
+} report_transport_t;
+
+/* What drives prep ticks, mission seconds and arrest holds in a gang process */
+typedef enum {
+    CLOCK_MODE_REAL = 0,     // wall clock (default)
+    CLOCK_MODE_VIRTUAL       // discrete events: idle time is skipped, not slept
+} clock_mode_t;
+
 /* Simulation parameters */
 //_____________________________________Talin added SAT
 typedef struct {
@@ -62,11 +92,25 @@ typedef struct {
     /* Simulation control */
     int   graphics_refresh_ms;
     int   logging_verbosity;
-    int   random_seed;
+    int   random_seed;          // seeds every PRNG stream; 0 = pick one at start-up
     int   ipc_timeout_ms;
     int   status_update_interval_s;
     int   max_simulation_runtime_s;
-    int   report_batch_size;
+    int   report_batch_size;   // police reports per mq message (≤ MAX_REPORT_BATCH)
+    int   report_flush_ms;     // longest a report waits for its batch to fill
+    int   report_queue_depth;  // frames per report/GUI mqueue (mq_maxmsg); 0 = 10
+    int   report_transport;    // report_transport_t, from "mqueue" / "shm_ring"
+    int   report_ring_slots;   // messages per shm ring (rounded up to a power of two)
+    int   event_log_records;   // transmission records per gang in distribution.evlog; 0 = off
+
+    /* In-process member queues */
+    int   msg_queue_depth;            // slots per member queue (rounded up to a power of two)
+    int   msg_queue_policy;           // queue_policy_t, from "block" / "drop_oldest" / "drop_newest"
+    int   gangs_per_process;          // gangs hosted by each gang_process (1 = one process per gang)
+    int   executor_workers;           // 0 = one thread per member, N = N-worker pool, -1 = one per core
+    int   clock_mode;                 // clock_mode_t, from "real" / "virtual" (virtual runs on the pool)
+    double time_scale;                // simulated seconds per wall-clock second, all processes (≤ 0 → 1)
+    int   police_enabled;             // spawn the police process (default 1)
     
     int num_missions;  //new new new HALA: new field for number of missions*****************
 
@@ -79,6 +123,8 @@ void print_config();
 int load_config_json(const char *path);
 //_____________________________________________________________________-Talin SUN
 int load_crimes_json(const char *path);
+/* Text of the snippet behind `code`, or "(unknown intel)" if out of range. */
+const char *intel_text(const Config *c, intel_code_t code);
 
 
 
@@ -0,0 +1,109 @@
+/* file: distlog_decode.c */
+// Decode a binary transmission log (evlog.h) into the old distribution.log
+// text: `ts Thread[a] -> Thread[b]: "intel"`, merged across gangs in time
+// order. Usage: distlog_decode [-g gang] [-d] [log] [crimes.json]
+//   -g gang  only that gang's segment
+//   -d       also print queue-full drops, tagged " (dropped)"
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "config.h"
+#include "evlog.h"
+
+static int by_time(const void *a, const void *b)
+{
+    const evlog_rec_t *x = *(const evlog_rec_t *const *)a;
+    const evlog_rec_t *y = *(const evlog_rec_t *const *)b;
+    if (x->ts_ns != y->ts_ns)
+        return x->ts_ns < y->ts_ns ? -1 : 1;
+    // same nanosecond: segment order, then claim order
+    return x < y ? -1 : x > y;
+}
+
+int main(int argc, char **argv)
+{
+    int only_gang = -1, with_drops = 0, opt;
+    while ((opt = getopt(argc, argv, "g:d")) != -1)
+    {
+        switch (opt)
+        {
+        case 'g':
+            only_gang = atoi(optarg);
+            break;
+        case 'd':
+            with_drops = 1;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-g gang] [-d] [log] [crimes.json]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    const char *log_path = optind < argc ? argv[optind++] : EVLOG_PATH;
+    const char *crimes_path = optind < argc ? argv[optind++] : "crimes.json";
+
+    if (load_crimes_json(crimes_path) < 0)
+    {
+        fprintf(stderr, "ERROR: could not load crimes '%s'\n", crimes_path);
+        return EXIT_FAILURE;
+    }
+    evlog_t log;
+    if (evlog_open(&log, log_path, 0) == -1)
+    {
+        fprintf(stderr, "ERROR: '%s' is not a readable event log\n", log_path);
+        return EXIT_FAILURE;
+    }
+    const evlog_header_t *h = log.hdr;
+
+    size_t total = 0;
+    for (uint32_t g = 0; g < h->num_gangs; g++)
+    {
+        uint64_t n = atomic_load(&h->seg[g].next);
+        total += n < h->records_per_gang ? n : h->records_per_gang;
+    }
+    const evlog_rec_t **recs = malloc((total ? total : 1) * sizeof *recs);
+    if (!recs)
+    {
+        perror("malloc");
+        return EXIT_FAILURE;
+    }
+
+    size_t count = 0;
+    for (uint32_t g = 0; g < h->num_gangs; g++)
+    {
+        if (only_gang >= 0 && (uint32_t)only_gang != g)
+            continue;
+        uint64_t n = atomic_load(&h->seg[g].next);
+        if (n > h->records_per_gang)
+            n = h->records_per_gang;
+        const evlog_rec_t *seg = &log.recs[(uint64_t)g * h->records_per_gang];
+        for (uint64_t i = 0; i < n; i++)
+        {
+            // EV_NONE: claimed by a writer that died before publishing
+            uint8_t kind = __atomic_load_n(&seg[i].kind, __ATOMIC_ACQUIRE);
+            if (kind == EV_SEND || (with_drops && kind == EV_DROP))
+                recs[count++] = &seg[i];
+        }
+    }
+    qsort(recs, count, sizeof *recs, by_time);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const evlog_rec_t *r = recs[i];
+        printf("%ld Thread[%d] -> Thread[%d]: \"%s\"%s\n",
+               (long)(r->ts_ns / 1000000000ull), r->from, r->to,
+               intel_text(&cfg, r->intel), r->kind == EV_DROP ? " (dropped)" : "");
+    }
+
+    for (uint32_t g = 0; g < h->num_gangs; g++)
+    {
+        uint64_t n = atomic_load(&h->seg[g].next);
+        uint64_t lost = atomic_load(&h->seg[g].dropped);
+        if (lost)
+            fprintf(stderr, "gang %u: segment full, %llu of %llu events not recorded\n",
+                    g, (unsigned long long)lost, (unsigned long long)n);
+    }
+    free(recs);
+    evlog_close(&log);
+    return 0;
+}
@@ -0,0 +1,93 @@
+/* file: evlog.c */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "evlog.h"
+
+static size_t evlog_data_offset(uint32_t num_gangs)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t hdr = sizeof(evlog_header_t) + num_gangs * sizeof(evlog_seg_t);
+    return (hdr + page - 1) / page * page;
+}
+
+// Create (or truncate) the log and size it for every segment up front;
+// unwritten records stay sparse holes until touched.
+int evlog_create(const char *path, int num_gangs, int records_per_gang)
+{
+    if (num_gangs <= 0 || records_per_gang <= 0)
+        return -1;
+    size_t off = evlog_data_offset((uint32_t)num_gangs);
+    size_t bytes = off + (size_t)num_gangs * (size_t)records_per_gang * sizeof(evlog_rec_t);
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1)
+        return -1;
+    if (ftruncate(fd, (off_t)bytes) == -1)
+    {
+        close(fd);
+        return -1;
+    }
+    evlog_header_t *h = mmap(NULL, off, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (h == MAP_FAILED)
+        return -1;
+    h->version = EVLOG_VERSION;
+    h->record_size = sizeof(evlog_rec_t);
+    h->num_gangs = (uint32_t)num_gangs;
+    h->records_per_gang = (uint32_t)records_per_gang;
+    h->data_offset = off;
+    for (int g = 0; g < num_gangs; g++)
+    {
+        atomic_init(&h->seg[g].next, 0);
+        atomic_init(&h->seg[g].dropped, 0);
+    }
+    // the magic goes in last, so a half-initialised file never validates
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(h->magic, EVLOG_MAGIC, sizeof h->magic);
+    munmap(h, off);
+    return 0;
+}
+
+int evlog_open(evlog_t *log, const char *path, int writable)
+{
+    memset(log, 0, sizeof *log);
+    int fd = open(path, writable ? O_RDWR : O_RDONLY);
+    if (fd == -1)
+        return -1;
+    struct stat st;
+    if (fstat(fd, &st) == -1 || (size_t)st.st_size < sizeof(evlog_header_t))
+    {
+        close(fd);
+        return -1;
+    }
+    void *base = mmap(NULL, (size_t)st.st_size, writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                      MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+        return -1;
+
+    evlog_header_t *h = base;
+    size_t need = h->data_offset + (size_t)h->num_gangs * h->records_per_gang * sizeof(evlog_rec_t);
+    if (memcmp(h->magic, EVLOG_MAGIC, sizeof h->magic) != 0 || h->version != EVLOG_VERSION ||
+        h->record_size != sizeof(evlog_rec_t) || need > (size_t)st.st_size)
+    {
+        munmap(base, (size_t)st.st_size);
+        return -1;
+    }
+    log->hdr = h;
+    log->recs = (evlog_rec_t *)((char *)base + h->data_offset);
+    log->map_bytes = (size_t)st.st_size;
+    return 0;
+}
+
+void evlog_close(evlog_t *log)
+{
+    if (log->hdr)
+        munmap(log->hdr, log->map_bytes);
+    memset(log, 0, sizeof *log);
+}
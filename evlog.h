@@ -0,0 +1,86 @@
+/* file: evlog.h */
+#ifndef EVLOG_H
+#define EVLOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <time.h>
+
+// ───────────── Binary transmission event log ─────────────
+// One mmap'd file shared by every gang process. HQ creates it with one
+// fixed-size segment per gang; writers claim a record slot with a single
+// fetch_add on their segment's cursor, fill it in, and publish it by
+// storing `kind` last, so send_message() never locks, formats or writes.
+// A full segment drops (and counts) further events. distlog_decode turns
+// the file back into the old distribution.log text.
+
+#define EVLOG_PATH    "distribution.evlog"
+#define EVLOG_MAGIC   "OCFEVLG"
+#define EVLOG_VERSION 1
+
+typedef enum {
+    EV_NONE = 0,     // slot claimed but not yet published
+    EV_SEND,         // intel delivered to a member queue
+    EV_DROP          // intel lost to a full member queue
+} evlog_kind_t;
+
+typedef struct {
+    uint64_t ts_ns;      // simulated CLOCK_REALTIME, as the writer's clock reads it
+    uint16_t gang;
+    uint16_t from;
+    uint16_t to;
+    uint16_t intel;      // intel_code_t
+    uint8_t  kind;       // evlog_kind_t, written last
+    uint8_t  reserved[7];
+} evlog_rec_t;
+
+_Static_assert(sizeof(evlog_rec_t) == 24, "evlog_rec_t is an on-disk format");
+
+typedef struct {
+    _Alignas(64) _Atomic uint64_t next;   // slots claimed (may exceed capacity)
+    _Atomic uint64_t dropped;             // events lost to a full segment
+} evlog_seg_t;
+
+typedef struct {
+    char     magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t num_gangs;
+    uint32_t records_per_gang;
+    uint64_t data_offset;                 // first record, page aligned
+    evlog_seg_t seg[];                    // num_gangs cursors
+} evlog_header_t;
+
+typedef struct {
+    evlog_header_t *hdr;
+    evlog_rec_t    *recs;                 // gang g's segment starts at g * records_per_gang
+    size_t          map_bytes;
+} evlog_t;
+
+int  evlog_create(const char *path, int num_gangs, int records_per_gang);  // HQ, before any fork
+int  evlog_open(evlog_t *log, const char *path, int writable);
+void evlog_close(evlog_t *log);
+
+// Lock-free append to `gang`'s segment; a no-op on a closed log
+static inline void evlog_append(evlog_t *log, int64_t ts_ns, int gang, int from, int to, int intel,
+                                evlog_kind_t kind) {
+    evlog_header_t *h = log->hdr;
+    if (!h || (unsigned)gang >= h->num_gangs)
+        return;
+    evlog_seg_t *s = &h->seg[gang];
+    uint64_t i = atomic_fetch_add_explicit(&s->next, 1, memory_order_relaxed);
+    if (i >= h->records_per_gang) {
+        atomic_fetch_add_explicit(&s->dropped, 1, memory_order_relaxed);
+        return;
+    }
+    evlog_rec_t *r = &log->recs[(uint64_t)gang * h->records_per_gang + i];
+    r->ts_ns = (uint64_t)ts_ns;
+    r->gang = (uint16_t)gang;
+    r->from = (uint16_t)from;
+    r->to = (uint16_t)to;
+    r->intel = (uint16_t)intel;
+    __atomic_store_n(&r->kind, (uint8_t)kind, __ATOMIC_RELEASE);
+}
+
+#endif // EVLOG_H
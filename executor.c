@@ -0,0 +1,465 @@
+/* file: executor.c */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <errno.h>
+#include "executor.h"
+
+// ───── Per-worker deque ─────
+// Owner pushes/pops at `bottom`, thieves take from `top`. A short mutex
+// per deque keeps it simple; contention only happens while stealing.
+typedef struct {
+    pthread_mutex_t mtx;
+    task_t        **buf;
+    size_t          cap;          // power of two
+    size_t          top, bottom;
+} deque_t;
+
+typedef struct {
+    pthread_t    tid;
+    executor_t  *ex;
+    int          index;
+    deque_t      dq;
+} worker_t;
+
+struct executor {
+    int              nworkers;
+    worker_t        *workers;
+    pthread_mutex_t  mtx;         // guards timers, idle/stop and live
+    pthread_cond_t   cond;        // idle workers park here
+    pthread_cond_t   done;        // executor_wait() parks here
+    task_t         **timers;      // min-heap on wake_at
+    int              ntimers, timer_cap;
+    int              idle;
+    int              live;
+    int              stop;
+    int              virtual_time;
+    sim_clock_t     *clock;       // wake_at is in this clock
+    int              party;       // virtual time: our slot on the clock, -1 once left
+    int              clock_wait;  // virtual time: a worker is waiting on the clock
+    int              holds;       // executor_hold() callers; virtual time waits for 0
+    _Atomic long     queued;      // tasks sitting in any deque
+    _Atomic unsigned rr;          // round-robin target for outside submits
+};
+
+static __thread worker_t *tls_worker;
+
+static int ts_before(const struct timespec *a, const struct timespec *b)
+{
+    return a->tv_sec < b->tv_sec ||
+           (a->tv_sec == b->tv_sec && a->tv_nsec < b->tv_nsec);
+}
+
+// ───── deque ─────
+static void dq_push(deque_t *d, task_t *t)
+{
+    pthread_mutex_lock(&d->mtx);
+    if (d->bottom - d->top == d->cap)
+    {
+        task_t **nb = malloc(2 * d->cap * sizeof *nb);
+        if (!nb)
+        {
+            perror("executor: deque malloc");
+            exit(EXIT_FAILURE);
+        }
+        for (size_t i = d->top; i != d->bottom; i++)
+            nb[i & (2 * d->cap - 1)] = d->buf[i & (d->cap - 1)];
+        free(d->buf);
+        d->buf = nb;
+        d->cap *= 2;
+    }
+    d->buf[d->bottom++ & (d->cap - 1)] = t;
+    pthread_mutex_unlock(&d->mtx);
+}
+
+static task_t *dq_pop(deque_t *d)      // owner end (LIFO)
+{
+    task_t *t = NULL;
+    pthread_mutex_lock(&d->mtx);
+    if (d->bottom != d->top)
+        t = d->buf[--d->bottom & (d->cap - 1)];
+    pthread_mutex_unlock(&d->mtx);
+    return t;
+}
+
+static task_t *dq_steal(deque_t *d)    // thief end (FIFO)
+{
+    task_t *t = NULL;
+    if (pthread_mutex_trylock(&d->mtx) != 0)
+        return NULL;                   // busy victim, try another
+    if (d->bottom != d->top)
+        t = d->buf[d->top++ & (d->cap - 1)];
+    pthread_mutex_unlock(&d->mtx);
+    return t;
+}
+
+// ───── timer heap (ex->mtx held) ─────
+static void timer_push(executor_t *ex, task_t *t)
+{
+    if (ex->ntimers == ex->timer_cap)
+    {
+        ex->timer_cap = ex->timer_cap ? 2 * ex->timer_cap : 64;
+        ex->timers = realloc(ex->timers, ex->timer_cap * sizeof *ex->timers);
+        if (!ex->timers)
+        {
+            perror("executor: timer heap realloc");
+            exit(EXIT_FAILURE);
+        }
+    }
+    int i = ex->ntimers++;
+    while (i > 0)
+    {
+        int p = (i - 1) / 2;
+        if (!ts_before(&t->wake_at, &ex->timers[p]->wake_at))
+            break;
+        ex->timers[i] = ex->timers[p];
+        i = p;
+    }
+    ex->timers[i] = t;
+}
+
+static task_t *timer_pop(executor_t *ex)
+{
+    task_t *top = ex->timers[0];
+    task_t *last = ex->timers[--ex->ntimers];
+    int i = 0;
+    for (;;)
+    {
+        int c = 2 * i + 1;
+        if (c >= ex->ntimers)
+            break;
+        if (c + 1 < ex->ntimers && ts_before(&ex->timers[c + 1]->wake_at, &ex->timers[c]->wake_at))
+            c++;
+        if (!ts_before(&ex->timers[c]->wake_at, &last->wake_at))
+            break;
+        ex->timers[i] = ex->timers[c];
+        i = c;
+    }
+    if (ex->ntimers > 0)
+        ex->timers[i] = last;
+    return top;
+}
+
+// ───── scheduling ─────
+static void enqueue(executor_t *ex, task_t *t)
+{
+    worker_t *w = (tls_worker && tls_worker->ex == ex)
+                      ? tls_worker
+                      : &ex->workers[atomic_fetch_add(&ex->rr, 1) % ex->nworkers];
+    atomic_fetch_add(&ex->queued, 1);
+    dq_push(&w->dq, t);
+
+    pthread_mutex_lock(&ex->mtx);
+    if (ex->idle > 0)
+        pthread_cond_signal(&ex->cond);
+    pthread_mutex_unlock(&ex->mtx);
+}
+
+void executor_spawn(executor_t *ex, task_t *t)
+{
+    t->ex = ex;
+    pthread_mutex_lock(&ex->mtx);
+    ex->live++;
+    pthread_mutex_unlock(&ex->mtx);
+    enqueue(ex, t);
+}
+
+static task_t *find_work(worker_t *self)
+{
+    executor_t *ex = self->ex;
+    task_t *t = dq_pop(&self->dq);
+    for (int i = 1; !t && i < ex->nworkers; i++)
+        t = dq_steal(&ex->workers[(self->index + i) % ex->nworkers].dq);
+    if (t)
+        atomic_fetch_sub(&ex->queued, 1);
+    return t;
+}
+
+static void release_parked(task_t *list);
+
+static void *worker_main(void *arg)
+{
+    worker_t *self = arg;
+    executor_t *ex = self->ex;
+    tls_worker = self;
+
+    for (;;)
+    {
+        task_t *t = find_work(self);
+        if (!t)
+        {
+            struct timespec now;
+            pthread_mutex_lock(&ex->mtx);
+            sim_now(ex->clock, &now);
+            if (ex->ntimers > 0 && !ts_before(&now, &ex->timers[0]->wake_at))
+            {
+                t = timer_pop(ex);
+                // let an idle worker take any event due with it
+                if (ex->ntimers > 0 && !ts_before(&now, &ex->timers[0]->wake_at))
+                    pthread_cond_signal(&ex->cond);
+            }
+            else if (ex->stop)
+            {
+                pthread_mutex_unlock(&ex->mtx);
+                break;
+            }
+            else if (atomic_load(&ex->queued) == 0)
+            {
+                ex->idle++;
+                if (ex->party >= 0 && ex->holds == 0 && ex->idle == ex->nworkers && !ex->clock_wait)
+                {
+                    if (ex->live == 0)
+                    {
+                        // every task is done: nothing here will ever need the clock again
+                        sim_v_leave(ex->clock, ex->party);
+                        ex->party = -1;
+                    }
+                    else
+                    {
+                        // nothing can run before the next timer: hand its deadline
+                        // to the shared clock and wait until it is our turn
+                        int64_t due = ex->ntimers > 0 ? sim_v_due(ex->clock, &ex->timers[0]->wake_at)
+                                                      : SIM_NEVER;
+                        uint32_t seen = sim_v_idle(ex->clock, ex->party, due);
+                        ex->clock_wait = 1;
+                        pthread_mutex_unlock(&ex->mtx);
+                        sim_v_wait(ex->clock, ex->party, seen);
+                        pthread_mutex_lock(&ex->mtx);
+                        ex->clock_wait = 0;
+                    }
+                }
+                else if (ex->ntimers > 0 && !ex->virtual_time)
+                {
+                    struct timespec until;
+                    sim_to_real(ex->clock, &ex->timers[0]->wake_at, &until);
+                    pthread_cond_timedwait(&ex->cond, &ex->mtx, &until);
+                }
+                else
+                    pthread_cond_wait(&ex->cond, &ex->mtx);
+                ex->idle--;
+            }
+            pthread_mutex_unlock(&ex->mtx);
+            if (!t)
+                continue;
+        }
+
+        switch (t->fn(t))
+        {
+        case TASK_DONE:
+            pthread_mutex_lock(&ex->mtx);
+            if (--ex->live == 0)
+                pthread_cond_broadcast(&ex->done);
+            pthread_mutex_unlock(&ex->mtx);
+            break;
+        case TASK_YIELD:
+            enqueue(ex, t);
+            break;
+        case TASK_SLEEP:
+            pthread_mutex_lock(&ex->mtx);
+            timer_push(ex, t);
+            if (ex->idle > 0)
+                pthread_cond_signal(&ex->cond); // may be the new earliest deadline
+            pthread_mutex_unlock(&ex->mtx);
+            break;
+        case TASK_PARKED:
+        {
+            task_barrier_t *b = t->park_on;
+            pthread_mutex_lock(&b->mtx);
+            if (++b->arrived < b->count)
+            {
+                t->next = b->parked;
+                b->parked = t;
+                pthread_mutex_unlock(&b->mtx);
+                break;
+            }
+            // last one in: release the generation and keep running
+            task_t *list = b->parked;
+            b->parked = NULL;
+            b->arrived = 0;
+            b->generation++;
+            pthread_cond_broadcast(&b->cond);
+            pthread_mutex_unlock(&b->mtx);
+            release_parked(list);
+            enqueue(ex, t);
+            break;
+        }
+        }
+    }
+    return NULL;
+}
+
+executor_t *executor_create(int nworkers, int virtual_time, sim_clock_t *clock)
+{
+    if (nworkers <= 0)
+        nworkers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (nworkers <= 0)
+        nworkers = 1;
+
+    executor_t *ex = calloc(1, sizeof *ex);
+    if (!ex)
+        return NULL;
+    ex->nworkers = nworkers;
+    ex->virtual_time = virtual_time;
+    ex->clock = clock;
+    ex->party = virtual_time ? sim_v_join(clock, 1) : -1;
+    ex->workers = calloc(nworkers, sizeof *ex->workers);
+    if (!ex->workers)
+    {
+        perror("executor: calloc workers");
+        exit(EXIT_FAILURE);
+    }
+    pthread_mutex_init(&ex->mtx, NULL);
+    pthread_condattr_t ca;
+    pthread_condattr_init(&ca);
+    pthread_condattr_setclock(&ca, CLOCK_MONOTONIC);
+    pthread_cond_init(&ex->cond, &ca);
+    pthread_condattr_destroy(&ca);
+    pthread_cond_init(&ex->done, NULL);
+
+    for (int i = 0; i < nworkers; i++)
+    {
+        worker_t *w = &ex->workers[i];
+        w->ex = ex;
+        w->index = i;
+        pthread_mutex_init(&w->dq.mtx, NULL);
+        w->dq.cap = 64;
+        w->dq.buf = malloc(w->dq.cap * sizeof *w->dq.buf);
+        if (!w->dq.buf)
+        {
+            perror("executor: deque malloc");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int i = 0; i < nworkers; i++)
+    {
+        if (pthread_create(&ex->workers[i].tid, NULL, worker_main, &ex->workers[i]) != 0)
+        {
+            perror("executor: pthread_create");
+            exit(EXIT_FAILURE);
+        }
+    }
+    return ex;
+}
+
+int executor_workers(const executor_t *ex)
+{
+    return ex->nworkers;
+}
+
+void executor_now(executor_t *ex, struct timespec *now)
+{
+    sim_now(ex->clock, now);
+}
+
+void executor_hold(executor_t *ex)
+{
+    pthread_mutex_lock(&ex->mtx);
+    ex->holds++;
+    pthread_mutex_unlock(&ex->mtx);
+}
+
+void executor_release(executor_t *ex)
+{
+    pthread_mutex_lock(&ex->mtx);
+    if (--ex->holds == 0)
+        pthread_cond_broadcast(&ex->cond); // idle workers may now advance the clock
+    pthread_mutex_unlock(&ex->mtx);
+}
+
+void executor_wait(executor_t *ex)
+{
+    pthread_mutex_lock(&ex->mtx);
+    while (ex->live > 0)
+        pthread_cond_wait(&ex->done, &ex->mtx);
+    pthread_mutex_unlock(&ex->mtx);
+}
+
+void executor_destroy(executor_t *ex)
+{
+    pthread_mutex_lock(&ex->mtx);
+    ex->stop = 1;
+    pthread_cond_broadcast(&ex->cond);
+    if (ex->clock_wait)
+        sim_v_kick(ex->clock, ex->party);
+    pthread_mutex_unlock(&ex->mtx);
+    for (int i = 0; i < ex->nworkers; i++)
+    {
+        pthread_join(ex->workers[i].tid, NULL);
+        free(ex->workers[i].dq.buf);
+        pthread_mutex_destroy(&ex->workers[i].dq.mtx);
+    }
+    if (ex->party >= 0)
+        sim_v_leave(ex->clock, ex->party);
+    free(ex->workers);
+    free(ex->timers);
+    pthread_mutex_destroy(&ex->mtx);
+    pthread_cond_destroy(&ex->cond);
+    pthread_cond_destroy(&ex->done);
+    free(ex);
+}
+
+// ───── barrier ─────
+static void release_parked(task_t *list)
+{
+    while (list)
+    {
+        task_t *next = list->next;
+        enqueue(list->ex, list);
+        list = next;
+    }
+}
+
+void task_barrier_init(task_barrier_t *b, int count)
+{
+    pthread_mutex_init(&b->mtx, NULL);
+    pthread_cond_init(&b->cond, NULL);
+    b->count = count;
+    b->arrived = 0;
+    b->generation = 0;
+    b->parked = NULL;
+}
+
+void task_barrier_destroy(task_barrier_t *b)
+{
+    pthread_mutex_destroy(&b->mtx);
+    pthread_cond_destroy(&b->cond);
+}
+
+void task_barrier_wait(task_barrier_t *b)
+{
+    pthread_mutex_lock(&b->mtx);
+    unsigned gen = b->generation;
+    if (++b->arrived >= b->count)
+    {
+        task_t *list = b->parked;
+        b->parked = NULL;
+        b->arrived = 0;
+        b->generation++;
+        pthread_cond_broadcast(&b->cond);
+        pthread_mutex_unlock(&b->mtx);
+        release_parked(list);
+        return;
+    }
+    while (gen == b->generation)
+        pthread_cond_wait(&b->cond, &b->mtx);
+    pthread_mutex_unlock(&b->mtx);
+}
+
+void task_barrier_drop(task_barrier_t *b)
+{
+    task_t *list = NULL;
+    pthread_mutex_lock(&b->mtx);
+    b->count--;
+    if (b->arrived > 0 && b->arrived >= b->count)
+    {
+        list = b->parked;
+        b->parked = NULL;
+        b->arrived = 0;
+        b->generation++;
+        pthread_cond_broadcast(&b->cond);
+    }
+    pthread_mutex_unlock(&b->mtx);
+    release_parked(list);
+}
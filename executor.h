@@ -0,0 +1,80 @@
+/* file: executor.h */
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include <pthread.h>
+#include <time.h>
+#include "simclock.h"
+
+// ───────────── Work-stealing task executor ─────────────
+// A fixed pool of worker threads (one per core by default), each owning
+// a deque of runnable tasks. Owners push/pop at the bottom; idle workers
+// steal from the top of a victim's deque. Tasks are resumable steps:
+// each call to fn() runs until the task has to wait, then reports how it
+// wants to continue.
+//
+// With virtual time the pool is a discrete-event engine: the timer heap
+// is the event queue, and once every worker is idle with nothing queued
+// (and no holds) the pool hands its earliest wake_at to the shared clock
+// (sim_v_idle) instead of sleeping until it; the clock jumps there once
+// every other process is idle too. Steps see the same order of ticks as
+// in real time, only without the idle gaps.
+
+typedef enum {
+    TASK_DONE,      // finished; never run again
+    TASK_YIELD,     // runnable again right away
+    TASK_SLEEP,     // run again once wake_at (executor_now() clock) has passed
+    TASK_PARKED     // arrive at park_on; resubmitted once the barrier releases
+} task_status_t;
+
+typedef struct task task_t;
+typedef struct executor executor_t;
+struct task_barrier;
+
+struct task {
+    task_status_t        (*fn)(task_t *t);
+    void                  *arg;
+    struct timespec        wake_at;   // for TASK_SLEEP
+    struct task_barrier   *park_on;   // for TASK_PARKED
+    executor_t            *ex;
+    task_t                *next;      // parked-list bookkeeping
+};
+
+// nworkers <= 0 → one per core. Timers follow `clock` (NULL = wall
+// clock); with virtual time the pool joins it as one party, which must
+// be one HQ counted in sim_v_start().
+executor_t *executor_create(int nworkers, int virtual_time, sim_clock_t *clock);
+void        executor_spawn(executor_t *ex, task_t *t);  // start a new task
+void        executor_wait(executor_t *ex);           // until every task is DONE
+void        executor_destroy(executor_t *ex);
+int         executor_workers(const executor_t *ex);
+// simulated CLOCK_MONOTONIC, virtual or not
+void        executor_now(executor_t *ex, struct timespec *now);
+// While held, virtual time stands still: hold before spawning a batch of
+// tasks that must all start at the same instant, release once they are in.
+// With virtual time, outside threads may only hold (and spawn) before
+// their first release: an idle pool is not woken by them.
+void        executor_hold(executor_t *ex);
+void        executor_release(executor_t *ex);
+
+// ───────────── Mixed thread/task barrier ─────────────
+// Threads block in task_barrier_wait(); tasks set park_on and return
+// TASK_PARKED. The executor only parks a task after its step returned,
+// so a release can never run it twice. The last arrival releases
+// everyone: sleeping threads are woken and parked tasks resubmitted.
+typedef struct task_barrier {
+    pthread_mutex_t  mtx;
+    pthread_cond_t   cond;
+    int              count;      // participants per generation
+    int              arrived;
+    unsigned         generation;
+    task_t          *parked;
+} task_barrier_t;
+
+void task_barrier_init(task_barrier_t *b, int count);
+void task_barrier_destroy(task_barrier_t *b);
+void task_barrier_wait(task_barrier_t *b);
+// permanently remove one participant (a member that died or was executed)
+void task_barrier_drop(task_barrier_t *b);
+
+#endif // EXECUTOR_H
@@ -1,4 +1,5 @@
 #define _XOPEN_SOURCE 600
+#define _DEFAULT_SOURCE // syscall(), for the futex under simclock.h
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -9,19 +10,20 @@
 #include <time.h>
 #include <math.h>
 #include "ipc_utils.h"
+#include "executor.h"
+#include "log.h"
+#include "evlog.h"
 #include <signal.h>
 #include <signal.h>
 #include <unistd.h>
 #include <pthread.h>
 
-#define POLICE_QUEUE_NAME "/ocf_sim_police"
 // #define NUM_MISSIONS 7
 #define zeta 0.1
 #define alpha 0.8
 #define CLAMP(x, lo, hi) (((x) < (lo)) ? (lo) : ((x) > (hi)) ? (hi) \
                                                              : (x))
 // ######################################################################Talin Graph
-#define MAX_INTEL 1024
 #define CRED_MIN 0.05
 #define CRED_MAX 0.95
 
@@ -29,42 +31,208 @@
 #define RANK_COEFF 0.3 // up to +0.3 from rank
 #define PERF_COEFF 0.5 // up to +0.5 from performance
 #define LUCK_COEFF 0.2 // up to ±0.2 from luck
-static intel_t *intel_db[MAX_INTEL];
-static int intel_count = 0;
+
 // ######################################################################3
 
-// ───── In-process FIFO queues (for leader→member messages) ─────
-static msg_queue_t *queues;
+// ───── Bump arena ─────
+// Chunked pointer-bump allocator. Nothing is freed individually; a reset
+// rewinds to the first chunk and reuses every chunk already obtained, so
+// steady-state allocation never reaches malloc.
+#define ARENA_CHUNK_SIZE (64 * 1024)
+
+typedef struct arena_chunk
+{
+    struct arena_chunk *next;
+    size_t used;
+    _Alignas(16) char data[ARENA_CHUNK_SIZE];
+} arena_chunk_t;
+
+typedef struct
+{
+    arena_chunk_t *head; // first chunk
+    arena_chunk_t *cur;  // chunk being bumped
+} arena_t;
+
+static void *arena_alloc(arena_t *a, size_t size)
+{
+    size = (size + 15) & ~(size_t)15;
+    if (size > ARENA_CHUNK_SIZE)
+        return NULL;
+    if (!a->cur || a->cur->used + size > ARENA_CHUNK_SIZE)
+    {
+        arena_chunk_t *next = a->cur ? a->cur->next : a->head;
+        if (!next)
+        {
+            next = malloc(sizeof *next);
+            if (!next)
+                return NULL;
+            next->next = NULL;
+            if (a->cur)
+                a->cur->next = next;
+            else
+                a->head = next;
+        }
+        next->used = 0;
+        a->cur = next;
+    }
+    void *p = a->cur->data + a->cur->used;
+    a->cur->used += size;
+    return p;
+}
+
+static void arena_reset(arena_t *a)
+{
+    a->cur = a->head;
+    if (a->cur)
+        a->cur->used = 0;
+}
+
+static void arena_destroy(arena_t *a)
+{
+    arena_chunk_t *c = a->head;
+    while (c)
+    {
+        arena_chunk_t *next = c->next;
+        free(c);
+        c = next;
+    }
+    a->head = a->cur = NULL;
+}
+
+// ───── Per-gang state ─────
+// Everything one gang owns. A gang_process hosts one gang per gang id on
+// its command line; hosted gangs share the shm mapping, the police queue
+// handle, the signal handlers and the member executor.
+typedef struct gang_ctx
+{
+    int gang_id;
+    pthread_t thread; // runs gang_main()
+    police_queue_t ingest; // this gang's own police ingest queue
+    police_queue_t *pq;    // → ingest
+    int **subordinates;
+    int *sub_count;
+    int num_members;
+    int leader_id;
+    pthread_t *members;
+    thread_args_t *member_args;
+    int mission_intel_count;
+    volatile int arrested;
+    int rank_occurrence[11];
+    rng_t rng; // used only by gang_main
+    // ───── In-process FIFO queues (for leader→member messages) ─────
+    msg_queue_t *queues;
+    intel_t intel_db[MAX_INTEL_CODES]; // transmission history, indexed by intel code
+    // leader-reachability per intel (see record_transmission), under graph_mtx
+    pthread_mutex_t graph_mtx;
+    struct intel_graph_s *graph[MAX_INTEL_CODES];
+    int *suspicion_count; // accusations per member; the leader never gets any
+    intel_code_t *suspect_intel; // last intel that reached each member
+    int most_suspected;   // argmax of suspicion_count, -1 if none yet
+    int *graph_stack;     // num_members scratch for reachability walks
+    arena_t history_arena; // this mission's transmission_t records
+    // executor mode: member tasks of this gang that have not finished yet
+    pthread_mutex_t tasks_mtx;
+    pthread_cond_t tasks_done;
+    int tasks_running;
+    // agent reports waiting to go to the police as one message (see report_submit)
+    pthread_mutex_t report_mtx;
+    pthread_cond_t report_cond; // CLOCK_MONOTONIC
+    police_batch_t report_batch;
+    struct timespec report_deadline; // flush by then; valid while count > 0
+    int report_stop;
+    pthread_t report_flusher;
+    task_t report_task; // virtual time: the flusher, as a task
+    int report_armed;   // report_task is live
+} gang_ctx_t;
+
 // ───── Prototypes for our in-process FIFO helpers ─────
-void send_message(int from_id, int to_id, const char *text);
-message_t receive_message(int my_id);
-int try_receive_message(int my_id, message_t *out);
-
-int **subordinates;
-int *sub_count;
-int NUM_MEMBERS;
-pthread_t *members;
-thread_args_t *member_args;
-int mission_intel_count;
+void send_message(gang_ctx_t *g, int from_id, int to_id, intel_code_t intel);
+message_t receive_message(gang_ctx_t *g, int my_id);
+int try_receive_message(gang_ctx_t *g, int my_id, message_t *out);
+int timed_receive_message(gang_ctx_t *g, int my_id, message_t *out, const struct timespec *deadline);
+static void flush_blocked_sends(thread_args_t *ta);
+
+// the member or leader whose step this executor worker is running
+static __thread thread_args_t *task_sender;
+
+static void timespec_add_us(struct timespec *ts, long us)
+{
+    ts->tv_sec += us / 1000000;
+    ts->tv_nsec += (us % 1000000) * 1000;
+    if (ts->tv_nsec >= 1000000000L)
+    {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
 shm_layout_t *shm;
-volatile int arrested = 0;
+static gang_ctx_t *gangs; // the gangs hosted by this process
+static int num_hosted;
+// non-NULL when members run as tasks on a worker pool (cfg.executor_workers)
+static executor_t *member_pool;
+// binary transmission log shared with the other gang processes (EVLOG_PATH)
+static evlog_t event_log;
+
+// Simulated wall-clock time in ns for stamps, virtual or wall-scaled
+static int64_t gang_now_ns(void)
+{
+    return sim_realtime_ns(&shm->clock);
+}
 
-static void handle_sigusr1(int signo)
+// Hold every member of one gang: threads get SIGUSR2, tasks a freeze flag.
+static void gang_arrest(gang_ctx_t *g)
 {
-    arrested = 1;
-    for (int i = 0; i < NUM_MEMBERS; ++i)
+    g->arrested = 1;
+    if (!g->member_args)
+        return; // still setting up
+    for (int i = 0; i < g->num_members; ++i)
     {
-        pthread_kill(members[i], SIGUSR2);
+        if (i == g->leader_id)
+            continue;
+        if (member_pool)
+            g->member_args[i].freeze = 1; // picked up at the task's next step
+        else if (g->members[i])
+            pthread_kill(g->members[i], SIGUSR2);
     }
 }
+
+// The police sigqueue() the arrested gang's id with SIGUSR1; a plain
+// kill() arrests every gang hosted here. arrests_taken tells a police
+// running on virtual time that the arrest is in.
+static void handle_sigusr1(int signo, siginfo_t *si, void *ucontext)
+{
+    (void)signo;
+    (void)ucontext;
+    for (int k = 0; k < num_hosted; ++k)
+        if (si->si_code != SI_QUEUE || si->si_value.sival_int == gangs[k].gang_id)
+        {
+            gang_arrest(&gangs[k]);
+            SHM_ADD(&shm->per_gang[gangs[k].gang_id].arrests_taken, 1);
+        }
+}
+// the member whose thread this is (thread mode), for handle_sigusr2()
+static __thread thread_args_t *member_self;
+
+// Only flags the hold: logging and sleeping are not async-signal-safe,
+// so member_thread() serves it at its next prep tick.
 static void handle_sigusr2(int signo)
 {
-    // NOTE: sleep() is async-signal-safe on POSIX, so this is okay.
-    printf("🐌 Thread %lu got SIGUSR1 — sleeping 15s…\n",
-           (unsigned long)pthread_self());
-    sleep(15);
-    printf("🏃 Thread %lu resuming\n",
-           (unsigned long)pthread_self());
+    (void)signo;
+    if (member_self)
+        member_self->freeze = 1;
+}
+
+// HQ ends the run with SIGTERM. It is blocked everywhere and taken here,
+// so what the gangs logged reaches stdout before the process goes.
+static void *term_thread(void *arg)
+{
+    sigset_t *term = arg;
+    int signo;
+    sigwait(term, &signo);
+    LOG(LOG_INFO, "\U0001F6D1 [GangProcess] Terminated by HQ.\n");
+    log_flush();
+    _exit(EXIT_SUCCESS);
 }
 
 float get_base_prob(int rank)
@@ -81,568 +249,1074 @@ float get_base_prob(int rank)
     return (float)rank / (float)max_rank;
 }
 // ################################################################Talin graph
-//  1) create or find an intel object
-static intel_t *find_or_create_intel(const char *text)
-{
-    for (int i = 0; i < intel_count; i++)
-        if (strcmp(intel_db[i]->text, text) == 0)
-            return intel_db[i];
-    if (intel_count >= MAX_INTEL)
-        return NULL; // out of space
-
-    intel_t *in = malloc(sizeof *in);
-    in->text = strdup(text);
-    in->history = NULL;
-    intel_db[intel_count++] = in;
-    return in;
+//  1) find an intel object: the code indexes intel_db directly, so there
+//     is no text lookup (and no index to build) on the send path
+static intel_t *find_intel(gang_ctx_t *g, intel_code_t code)
+{
+    if (code >= MAX_INTEL_CODES || !g->intel_db[code].text)
+        return NULL;
+    return &g->intel_db[code];
+}
+
+// ───── Incremental leader-reachability, per intel ─────
+// For each intel the gang keeps who has been reached from the leader and
+// through whom (parent), plus each sender's out-edges so that a member
+// reached late can pass reachability on along what it sent earlier.
+// Every member that becomes reachable earns one accusation; the
+// most-accused member is tracked as accusations land, so the suspect
+// is known the moment the gang gets arrested.
+#define GRAPH_UNREACHED (-2)
+#define GRAPH_ROOT (-1)
+
+typedef struct intel_graph_s
+{
+    transmission_t **out; // per sender, chained through next_from
+    int *parent;          // GRAPH_UNREACHED, GRAPH_ROOT (leader) or member id
+} intel_graph_t;
+
+static intel_graph_t *intel_graph(gang_ctx_t *g, intel_code_t intel)
+{
+    intel_graph_t *gr = g->graph[intel];
+    if (gr)
+        return gr;
+    gr = malloc(sizeof *gr);
+    gr->out = calloc(g->num_members, sizeof *gr->out);
+    gr->parent = malloc(g->num_members * sizeof *gr->parent);
+    for (int m = 0; m < g->num_members; m++)
+        gr->parent[m] = GRAPH_UNREACHED;
+    gr->parent[g->leader_id] = GRAPH_ROOT;
+    g->graph[intel] = gr;
+    return gr;
+}
+
+static void accuse(gang_ctx_t *g, int m, intel_code_t intel)
+{
+    g->suspicion_count[m]++;
+    g->suspect_intel[m] = intel;
+    if (g->most_suspected < 0 ||
+        g->suspicion_count[m] > g->suspicion_count[g->most_suspected])
+        g->most_suspected = m;
+}
+
+// Take back one accusation from `m` and re-find the most-accused member.
+static void unaccuse(gang_ctx_t *g, int m)
+{
+    if (g->suspicion_count[m] > 0)
+        g->suspicion_count[m]--;
+    if (m != g->most_suspected)
+        return;
+    g->most_suspected = -1;
+    for (int i = 0; i < g->num_members; i++)
+    {
+        if (g->suspicion_count[i] > 0 &&
+            (g->most_suspected < 0 || g->suspicion_count[i] > g->suspicion_count[g->most_suspected]))
+            g->most_suspected = i;
+    }
+}
+
+// `to` just heard `intel` from a reachable `from`: mark it and everyone
+// it (transitively) already forwarded the intel to.
+static void graph_reach(gang_ctx_t *g, intel_graph_t *gr, intel_code_t intel, int from, int to)
+{
+    if (gr->parent[to] != GRAPH_UNREACHED)
+        return;
+    int top = 0;
+    gr->parent[to] = from;
+    accuse(g, to, intel);
+    g->graph_stack[top++] = to;
+    while (top > 0)
+    {
+        int u = g->graph_stack[--top];
+        for (transmission_t *t = gr->out[u]; t; t = t->next_from)
+        {
+            if (gr->parent[t->to] != GRAPH_UNREACHED)
+                continue;
+            gr->parent[t->to] = u;
+            accuse(g, t->to, intel);
+            g->graph_stack[top++] = t->to;
+        }
+    }
+}
+
+// An edge was removed: walk from the leader again over what is left.
+// Members no longer reached go back to GRAPH_UNREACHED and give back the
+// accusation they earned; removing an edge never reaches anyone new.
+#define GRAPH_STALE (-3)
+
+static void graph_rewalk(gang_ctx_t *g, intel_graph_t *gr)
+{
+    int top = 0;
+    for (int m = 0; m < g->num_members; m++)
+    {
+        if (gr->parent[m] >= 0)
+            gr->parent[m] = GRAPH_STALE;
+    }
+    g->graph_stack[top++] = g->leader_id;
+    while (top > 0)
+    {
+        int u = g->graph_stack[--top];
+        for (transmission_t *t = gr->out[u]; t; t = t->next_from)
+        {
+            if (gr->parent[t->to] != GRAPH_STALE)
+                continue;
+            gr->parent[t->to] = u;
+            g->graph_stack[top++] = t->to;
+        }
+    }
+    for (int m = 0; m < g->num_members; m++)
+    {
+        if (gr->parent[m] != GRAPH_STALE)
+            continue;
+        gr->parent[m] = GRAPH_UNREACHED;
+        unaccuse(g, m);
+    }
 }
 
 // 2) record every send
-void record_transmission(const char *text, int from, int to)
+void record_transmission(gang_ctx_t *g, intel_code_t intel, int from, int to, time_t ts)
 {
-    intel_t *in = find_or_create_intel(text);
-    if (!in)
-        return; // fail silently if too many
-    transmission_t *t = malloc(sizeof *t);
+    intel_t *in = find_intel(g, intel);
+    if (!in || from < 0 || from >= g->num_members || to < 0 || to >= g->num_members)
+        return; // fail silently on unknown codes or ids
+    pthread_mutex_lock(&g->graph_mtx);
+    transmission_t *t = arena_alloc(&g->history_arena, sizeof *t);
+    if (!t)
+    {
+        pthread_mutex_unlock(&g->graph_mtx);
+        return;
+    }
     t->from = from;
     t->to = to;
-    t->ts = time(NULL);
+    t->ts = ts;
     t->next = in->history;
     in->history = t;
+
+    intel_graph_t *gr = intel_graph(g, intel);
+    t->next_from = gr->out[from];
+    gr->out[from] = t;
+    if (gr->parent[from] != GRAPH_UNREACHED)
+        graph_reach(g, gr, intel, from, to);
+    pthread_mutex_unlock(&g->graph_mtx);
 }
 
-// 3) a simple trace for a particular intel
-void dump_intel_history(const char *text)
+// A recorded message never reached `to` (evicted from its queue unread):
+// unlink its transmission and undo whatever reachability hung on it. The
+// record itself stays in the arena until the mission's reset; if that
+// reset already ran there is nothing left to undo.
+static void forget_transmission(gang_ctx_t *g, intel_code_t intel, int from, int to, time_t ts)
 {
-    intel_t *in = find_or_create_intel(text);
-    if (!in)
-    {
-        printf("No intel found for “%s”\n", text);
+    intel_t *in = find_intel(g, intel);
+    if (!in || from < 0 || from >= g->num_members || to < 0 || to >= g->num_members)
         return;
-    }
-    printf("History for “%s”:\n", in->text);
-    for (transmission_t *t = in->history; t; t = t->next)
+    pthread_mutex_lock(&g->graph_mtx);
+    transmission_t **pp = &in->history;
+    while (*pp && !((*pp)->from == from && (*pp)->to == to && (*pp)->ts == ts))
+        pp = &(*pp)->next;
+    transmission_t *t = *pp;
+    if (t)
     {
-        printf("  %ld: %d → %d\n", t->ts, t->from, t->to);
+        *pp = t->next;
+        intel_graph_t *gr = g->graph[intel];
+        for (pp = &gr->out[from]; *pp != t; pp = &(*pp)->next_from)
+            ;
+        *pp = t->next_from;
+        if (gr->parent[to] == from)
+            graph_rewalk(g, gr);
     }
+    pthread_mutex_unlock(&g->graph_mtx);
 }
-// ------------------------------------------------------------------
-// Helper: Find one path from start to target in a directed graph.
-//   adj      : adjacency lists (size num_members, each is an array of ints)
-//   adj_count: number of neighbors in each adj[u]
-//   visited  : temp array, initialized to false
-//   stack    : temp array to hold current path
-//   depth    : current depth in stack
-//   out_path : output array (size num_members) to receive the found path
-//   out_len  : output length
-// Returns true if a path is found.
-static bool dfs_find_path(int start, int target,
-                          int num_members,
-                          int **adj, int *adj_count,
-                          bool *visited,
-                          int *stack, int depth,
-                          int *out_path, int *out_len)
-{
-    if (start == target)
-    {
-        // record final node
-        stack[depth] = start;
-        // copy stack[0..depth] into out_path
-        for (int i = 0; i <= depth; i++)
-            out_path[i] = stack[i];
-        *out_len = depth + 1;
-        return true;
-    }
-    visited[start] = true;
-    stack[depth] = start;
-
-    for (int i = 0; i < adj_count[start]; i++)
-    {
-        int nbr = adj[start][i];
-        if (!visited[nbr])
+
+// Forget this mission's transmissions: the history lists and the
+// reachability built on them live in the arena, which is rewound.
+// Accusation counts carry over to later missions.
+static void reset_transmissions(gang_ctx_t *g)
+{
+    pthread_mutex_lock(&g->graph_mtx);
+    for (int ii = 0; ii < MAX_INTEL_CODES; ii++)
+    {
+        g->intel_db[ii].history = NULL;
+        intel_graph_t *gr = g->graph[ii];
+        if (!gr)
+            continue;
+        for (int m = 0; m < g->num_members; m++)
         {
-            if (dfs_find_path(nbr, target,
-                              num_members,
-                              adj, adj_count,
-                              visited,
-                              stack, depth + 1,
-                              out_path, out_len))
-                return true;
+            gr->out[m] = NULL;
+            gr->parent[m] = GRAPH_UNREACHED;
         }
+        gr->parent[g->leader_id] = GRAPH_ROOT;
     }
-    return false;
+    arena_reset(&g->history_arena);
+    pthread_mutex_unlock(&g->graph_mtx);
 }
 
-// ###########################################################
-
-int rank_occurrence[11] = {0};
 // ##############################################33 ranking levels
-float assign_info_accuracy(int rank)
+float assign_info_accuracy(gang_ctx_t *g, int rank)
 {
     float base = get_base_prob(rank);
-    int index = rank_occurrence[rank]++;
+    int index = g->rank_occurrence[rank]++;
     return base + ((index % shm->cfg.ranking_levels) / 100.0);
 }
 // ------------------------------------------------------------------
-// Replacement analyze function — no file I/O, uses intel_db[] graph.
+// Name the most-accused member, read off the incremental graph above,
+// with the leader → suspect path of the last intel that reached them.
+// That intel may date from an earlier mission whose transmissions were
+// reset since; the path then stops short of the leader and is printed
+// with an unknown origin. Returns -1 if no intel has reached anyone but
+// the leader yet.
+int analyze_distribution_log(gang_ctx_t *g,
+                             thread_args_t *members,
+                             int num_members)
+{
+    LOG(LOG_INFO, "\n\U0001F50E [INVESTIGATION] Tracing all leader-intel paths…\n");
 
-int analyze_distribution_log(thread_args_t *members,
-                             int num_members,
-                             int leader_id)
+    pthread_mutex_lock(&g->graph_mtx);
+    int most_susp_id = g->most_suspected;
+    if (most_susp_id < 0)
+    {
+        pthread_mutex_unlock(&g->graph_mtx);
+        LOG(LOG_INFO, "\n🔔 No member has been reached by leader intel yet\n\n");
+        return -1;
+    }
+    int max_accusations = g->suspicion_count[most_susp_id];
+    intel_code_t intel = g->suspect_intel[most_susp_id];
+    intel_graph_t *gr = g->graph[intel];
+    int *path = g->graph_stack;
+    int path_len = 0;
+    int from_leader = 0;
+    for (int node = most_susp_id; node >= 0 && path_len < num_members; node = gr->parent[node])
+    {
+        path[path_len++] = node;
+        from_leader = gr->parent[node] == GRAPH_ROOT;
+    }
+    pthread_mutex_unlock(&g->graph_mtx);
+
+    LOG(LOG_INFO, "\n📜 Intel: “%s”\n", intel_text(&shm->cfg, intel));
+    LOG(LOG_INFO, "🔍 Accusation[%d] for Member[%d]:\n    %s", max_accusations, most_susp_id,
+                  from_leader ? "" : "(origin unknown) → ");
+    for (int k = path_len - 1; k >= 0; k--)
+    {
+        int node = path[k];
+        LOG(LOG_INFO, "%d(%.2f)%s", node, members[node].credibility, k > 0 ? " → " : "\n");
+    }
+
+    LOG(LOG_INFO, "\n🔔 Most suspicious member: [%d] with %d accusations\n\n",
+                  most_susp_id, max_accusations);
+    return most_susp_id;
+}
+
+// What the leader keeps across the steps of one mission
+typedef struct
 {
-    printf("\n\U0001F50E [INVESTIGATION] Tracing all leader-intel paths…\n");
+    int mission_index;
+    int remaining; // leader intel not yet handed out
+} leader_mission_t;
 
-    // --- allocate working arrays ---
-    int **adj = malloc(num_members * sizeof(int *));
-    int *adj_count = calloc(num_members, sizeof(int));
-    bool *visited = calloc(num_members, sizeof(bool));
-    int *stack = malloc(num_members * sizeof(int));
-    int *out_path = malloc(num_members * sizeof(int));
+static void leader_begin(thread_args_t *ta)
+{
+    //// added new mayar
+    // ##############################################################################
+    gang_set_member(shm, ta->gang_id, ta->id, ta->rank, ta->prep_level); // prep likely 0 at the start
+    ////
 
-    // --- new: tally of how many times each member was “suspected” ---
-    int *suspicion_count = calloc(num_members, sizeof(int));
+    LOG(LOG_INFO, "\U0001F451 Leader[%d] from Gang[%d] waiting for members… (TID=%lu, \U0001F451Rank=%d)\n",
+                  ta->id, ta->gang_id, (unsigned long)pthread_self(), ta->rank);
+}
 
-    for (int ii = 0; ii < intel_count; ii++)
-    {
-        intel_t *in = intel_db[ii];
+static void leader_begin_mission(thread_args_t *ta, leader_mission_t *lm, int mission_num)
+{
+    gang_ctx_t *g = ta->gang;
+    LOG(LOG_INFO, "🚀 leader gang[%d] Starting Mission #%d\n", ta->gang_id, mission_num);
+    // every member is past the last barrier, so no sends are in flight
+    reset_transmissions(g);
+
+    // define mission info at leader's side
+    lm->mission_index = rng_below(&ta->rng, shm->cfg.num_crimes);
+    ta->mission_name = shm->cfg.crimes[lm->mission_index].name;
+    Crime *c = &shm->cfg.crimes[lm->mission_index];
+    for (int i = 0; i < c->legit_prep_intel_count; i++)
+        ta->leader_intel_used[i] = 0;
+    lm->remaining = c->legit_prep_intel_count;
+
+    LOG(LOG_INFO, "\U0001F4E2 Leader[%d] selected mission: %s\n", ta->id, ta->mission_name);
+    g->mission_intel_count = c->legit_prep_intel_count; // Talin FRI: store mission intel count
+}
 
-        // 1) build adjacency for this intel’s transmissions
-        for (transmission_t *t = in->history; t; t = t->next)
-            if (t->from >= 0 && t->from < num_members)
-                adj_count[t->from]++;
+// ——— send info(intel) to subordinates while preparing  ———
+static void leader_prep_tick(thread_args_t *ta, leader_mission_t *lm, int tick)
+{
+    gang_ctx_t *g = ta->gang;
+    Crime *c = &shm->cfg.crimes[lm->mission_index];
 
-        for (int u = 0; u < num_members; u++)
-        {
-            if (adj_count[u] > 0)
-                adj[u] = malloc(adj_count[u] * sizeof(int));
-            adj_count[u] = 0; // reset as insertion index
-        }
-        for (transmission_t *t = in->history; t; t = t->next)
-        {
-            int u = t->from;
-            adj[u][adj_count[u]++] = t->to;
-        }
+    // Talin FRI: compute how far along we are [0.0 .. 1.0]
+    double progress = tick / (double)ta->prep_ticks; // Talin FRI
 
-        printf("\n📜 Intel: “%s”\n", in->text);
+    // Talin FRI: ramp base_send up over time to avoid long end silence
+    double base_send = CLAMP(progress, 0.0, 1.0); // Talin FRI
 
-        // 2) for each member, see if there’s a path from leader → m
-        for (int m = 0; m < num_members; m++)
+    // Talin FRI: small random variation
+    double luck = (rng_unit(&ta->rng) - 0.5) * 0.05; // ±2.5% Talin FRI
+
+    // Talin FRI: final send probability combining ramp and luck
+    double send_prob = CLAMP(base_send + luck,
+                             0.0, 1.0); // Talin FRI
+
+    int me = ta->id;
+    int nsub = g->sub_count[me];
+    for (int si = 0; si < nsub; si++)
+    {
+        int sub_id = g->subordinates[me][si];
+        double r = rng_unit(&ta->rng);
+        if (r < send_prob && lm->remaining > 0)
         {
-            memset(visited, 0, num_members * sizeof(bool));
-            int path_len = 0;
-            bool found = dfs_find_path(leader_id, m,
-                                       num_members,
-                                       adj, adj_count,
-                                       visited,
-                                       stack, 0,
-                                       out_path, &path_len);
-            if (found)
+            // pick a random unused intel_idx
+            int intel_idx;
+            do
             {
-                // count one accusation for m
-                suspicion_count[m]++;
+                intel_idx = rng_below(&ta->rng, c->legit_prep_intel_count);
+            } while (ta->leader_intel_used[intel_idx]);
 
-                // (optional) still print the path details if you like:
-                printf("🔍 Accusation[%d] for Member[%d]:\n    ",
-                       suspicion_count[m], m);
-                for (int k = 0; k < path_len; k++)
-                {
-                    int node = out_path[k];
-                    printf("%d(%.2f)%s",
-                           node, members[node].credibility,
-                           (k + 1 < path_len) ? " → " : "\n");
-                }
-            }
+            // mark it used
+            ta->leader_intel_used[intel_idx] = 1;
+            lm->remaining--;
+
+            // broadcast exactly this snippet
+            send_message(g, me, sub_id, INTEL_CODE(lm->mission_index, intel_idx));
+            LOG(LOG_DEBUG, "✉  Leader[%d] → Member[%d]: “%s”\n",
+                           me, sub_id, c->legit_prep_intel[intel_idx]);
         }
+    }
+}
 
-        // free this intel’s adj lists
-        for (int u = 0; u < num_members; u++)
-            if (adj[u])
-                free(adj[u]);
+// One second of the mission; returns 1 if the leader was killed in it
+static int leader_mission_second(thread_args_t *ta)
+{
+    double r = rng_unit(&ta->rng);
+    if (r < shm->cfg.kill_rate)
+    {
+        LOG(LOG_INFO, "☠ Leader[%d] was killed during mission!\n", ta->id);
+        ta->is_dead = 1;
+        return 1;
     }
+    return 0;
+}
 
-    // --- find who got suspected the most ---
-    int most_susp_id = 0;
-    int max_accusations = suspicion_count[0];
-    for (int m = 1; m < num_members; m++)
+static void leader_end_mission(thread_args_t *ta)
+{
+    gang_ctx_t *g = ta->gang;
+    LOG(LOG_INFO, "\U0001F3C1 Leader[%d] mission complete, waiting at barrier…\n", ta->id);
+    if (g->arrested)
     {
-        if (suspicion_count[m] > max_accusations)
+        int suspected_agent_thread_id = analyze_distribution_log(g, g->member_args, g->num_members);
+        if (suspected_agent_thread_id >= 0)
         {
-            max_accusations = suspicion_count[m];
-            most_susp_id = m;
+            LOG(LOG_INFO, "\U0001F6A8 Leader[%d] arrested suspected agent thread %d\n", ta->id, suspected_agent_thread_id);
+            // the member sees this at its next barrier and leaves the gang
+            // (thread or task alike); it is reaped when the gang shuts down
+            g->member_args[suspected_agent_thread_id].is_dead = 1;
+            LOG(LOG_INFO, "✅ Killed thread %d\n", suspected_agent_thread_id);
         }
+        g->arrested = 0; // reset for next mission
     }
-
-    printf("\n🔔 Most suspicious member: [%d] with %d accusations\n\n",
-           most_susp_id, max_accusations);
-
-    // clean up
-    // free(suspicion_count);
-    free(adj_count);
-    free(visited);
-    free(stack);
-    free(out_path);
-
-    return most_susp_id;
 }
 
 void *leader_thread(void *arg)
 {
-
     thread_args_t *ta = arg;
-    //// added new mayar
-    // ##############################################################################
-    sem_wait(&shm->sem_gang[ta->gang_id]);
-    shm->gang_ranks[ta->gang_id][ta->id] = ta->rank;
-    shm->gang_prep_levels[ta->gang_id][ta->id] = ta->prep_level; // likely 0 at the start
-    sem_post(&shm->sem_gang[ta->gang_id]);
-    ////
-
-    printf("\U0001F451 Leader[%d] from Gang[%d] waiting for members… (TID=%lu, \U0001F451Rank=%d)\n",
-           ta->id, ta->gang_id, (unsigned long)pthread_self(), ta->rank);
-    fflush(stdout);
+    leader_mission_t lm;
+    leader_begin(ta);
     for (int mission_num = 1; mission_num <= shm->cfg.num_missions; mission_num++)
     {
-        printf("🚀 leader gang[] Starting Mission #%d\n", ta->gang_id, mission_num);
-
-        // define mission info at leader's side
-        srand(time(NULL) ^ ta->gang_id);
-        int mission_index = rand() % shm->cfg.num_crimes;
-        ta->mission_name = shm->cfg.crimes[mission_index].name;
-        Crime *c = &shm->cfg.crimes[mission_index];
-        for (int i = 0; i < c->legit_prep_intel_count; i++)
-            ta->leader_intel_used[i] = 0;
-        int remaining = c->legit_prep_intel_count;
-
-        printf("\U0001F4E2 Leader[%d] selected mission: %s\n", ta->id, ta->mission_name);
-        fflush(stdout);
-        mission_intel_count = c->legit_prep_intel_count; // Talin FRI: store mission intel count
-
-        pthread_barrier_wait(ta->barrier);
-        // ——— send info(intel) to subordinates while preparing  ———
+        leader_begin_mission(ta, &lm, mission_num);
+        task_barrier_wait(ta->barrier);
         for (int tick = 1; tick <= ta->prep_ticks; tick++)
         {
-            usleep(ta->prep_interval_us);
+            sim_usleep(&shm->clock, ta->prep_interval_us);
+            leader_prep_tick(ta, &lm, tick);
+        }
 
-            // Talin FRI: compute how far along we are [0.0 .. 1.0]
-            double progress = tick / (double)ta->prep_ticks; // Talin FRI
+        task_barrier_wait(ta->barrier);
+
+        LOG(LOG_INFO, "\U0001F680 Leader[%d] starting mission (duration=%ds)…\n", ta->id, ta->mission_duration_s);
+        // simulate death during mission
+        for (int sec = 0; sec < ta->mission_duration_s; sec++)
+        {
+            sim_sleep(&shm->clock, 1);
+            if (leader_mission_second(ta))
+            {
+                task_barrier_drop(ta->barrier); // the members must not wait for it
+                pthread_exit(NULL);
+            }
+        }
+        task_barrier_wait(ta->barrier);
+        leader_end_mission(ta);
+    }
+    return NULL;
+}
 
-            // Talin FRI: ramp base_send up over time to avoid long end silence
-            double base_send = CLAMP(progress, 0.0, 1.0); // Talin FRI
+// ───── Batched police reports ─────
+// Agents of a gang hand their reports to report_submit(); they leave as a
+// single police_batch_t once report_batch_size of them are pending or
+// report_flush_ms after the first one, whichever comes first.
+static int report_batch_limit(void)
+{
+    int n = shm->cfg.report_batch_size;
+    return n < 1 ? 1 : n > MAX_REPORT_BATCH ? MAX_REPORT_BATCH : n;
+}
 
-            // Talin FRI: small random variation
-            double luck = ((double)rand() / RAND_MAX - 0.5) * 0.05; // ±2.5% Talin FRI
+// report_mtx held: the batch leaves report_flush_ms from now at the
+// latest (simulated ms with virtual time, where the flusher is a task)
+static void report_arm(gang_ctx_t *g)
+{
+    if (shm->clock.virtual_time)
+        sim_now(&shm->clock, &g->report_deadline);
+    else
+        clock_gettime(CLOCK_MONOTONIC, &g->report_deadline);
+    timespec_add_us(&g->report_deadline, shm->cfg.report_flush_ms * 1000L);
+}
 
-            // Talin FRI: final send probability combining ramp and luck
-            double send_prob = CLAMP(base_send + luck,
-                                     0.0, 1.0); // Talin FRI
+// report_mtx held. A queue that is momentarily full keeps the batch for
+// the next deadline; any other failure drops it. A frame counts as in
+// flight on the virtual clock until the police listener has handled it.
+static void report_flush_locked(gang_ctx_t *g)
+{
+    police_batch_t *b = &g->report_batch;
+    if (b->count == 0)
+        return;
+    if (shm->cfg.police_enabled)
+        sim_v_post(&shm->clock);
+    if (pq_send_batch(g->pq, b) == 0)
+    {
+        LOG(LOG_DEBUG, "📨 Gang[%d] sent %u report(s) to police queue\n", g->gang_id, b->count);
+        b->count = 0;
+        return;
+    }
+    int e = errno;
+    if (shm->cfg.police_enabled)
+        sim_v_done(&shm->clock);
+    if (e == EAGAIN)
+    {
+        report_arm(g);
+        return;
+    }
+    errno = e;
+    perror("❌ Failed to send reports to police queue");
+    b->count = 0;
+}
 
-            int me = ta->id;
-            int nsub = sub_count[me];
-            for (int si = 0; si < nsub; si++)
+static void report_submit(gang_ctx_t *g, const police_report_t *r)
+{
+    pthread_mutex_lock(&g->report_mtx);
+    police_batch_t *b = &g->report_batch;
+    if (b->count >= report_batch_limit())
+        report_flush_locked(g); // a retry still pending
+    if (b->count >= report_batch_limit())
+    {
+        LOG(LOG_WARN, "❌ Gang[%d] police queue full, report from Member[%d] dropped\n",
+                      g->gang_id, r->member_id);
+    }
+    else
+    {
+        if (b->count == 0)
+        {
+            report_arm(g);
+            if (!shm->clock.virtual_time)
+                pthread_cond_signal(&g->report_cond);
+            else if (!g->report_armed)
             {
-                int sub_id = subordinates[me][si];
-                double r = rand() / (double)RAND_MAX;
-                if (r < send_prob && remaining > 0)
-                {
-                    // pick a random unused intel_idx
-                    int intel_idx;
-                    do
-                    {
-                        intel_idx = rand() % c->legit_prep_intel_count;
-                    } while (ta->leader_intel_used[intel_idx]);
-
-                    // mark it used
-                    ta->leader_intel_used[intel_idx] = 1;
-                    remaining--;
-
-                    const char *intel = c->legit_prep_intel[intel_idx];
-                    // broadcast exactly this snippet
-                    send_message(me, sub_id, intel);
-                    printf("✉  Leader[%d] → Member[%d]: “%s”\n",
-                           me, sub_id, intel);
-                }
+                g->report_armed = 1;
+                executor_spawn(member_pool, &g->report_task);
             }
         }
+        b->reports[b->count++] = *r;
+        if (b->count >= report_batch_limit())
+            report_flush_locked(g);
+    }
+    pthread_mutex_unlock(&g->report_mtx);
+}
+
+static void *report_flusher_thread(void *arg)
+{
+    gang_ctx_t *g = arg;
+    pthread_mutex_lock(&g->report_mtx);
+    while (!g->report_stop)
+    {
+        if (g->report_batch.count == 0)
+        {
+            pthread_cond_wait(&g->report_cond, &g->report_mtx);
+            continue;
+        }
+        if (pthread_cond_timedwait(&g->report_cond, &g->report_mtx, &g->report_deadline) == ETIMEDOUT)
+            report_flush_locked(g);
+    }
+    report_flush_locked(g); // whatever is left when the gang shuts down
+    pthread_mutex_unlock(&g->report_mtx);
+    return NULL;
+}
 
-        pthread_barrier_wait(ta->barrier);
+// Virtual time: armed by the first report of a batch, sleeps until its
+// deadline and ends once nothing is pending, or after one last try once
+// the gang shuts down.
+static task_status_t report_flush_step(task_t *t)
+{
+    gang_ctx_t *g = t->arg;
+    task_status_t st = TASK_DONE;
+    struct timespec now;
+    pthread_mutex_lock(&g->report_mtx);
+    executor_now(t->ex, &now);
+    if (g->report_batch.count > 0 &&
+        (g->report_stop || sim_ts_ns(&now) >= sim_ts_ns(&g->report_deadline)))
+        report_flush_locked(g);
+    if (g->report_batch.count > 0 && !g->report_stop)
+    {
+        t->wake_at = g->report_deadline;
+        st = TASK_SLEEP;
+    }
+    else
+    {
+        g->report_armed = 0;
+        pthread_cond_broadcast(&g->report_cond); // report_batcher_stop() may be waiting
+    }
+    pthread_mutex_unlock(&g->report_mtx);
+    return st;
+}
 
-        printf("\U0001F680 Leader[%d] starting mission (duration=%ds)…\n", ta->id, ta->mission_duration_s);
-        fflush(stdout);
-        // simulate death during mission
-        for (int sec = 0; sec < ta->mission_duration_s; sec++)
+static void report_batcher_start(gang_ctx_t *g)
+{
+    pthread_condattr_t ca;
+    pthread_condattr_init(&ca);
+    pthread_condattr_setclock(&ca, CLOCK_MONOTONIC);
+    pthread_mutex_init(&g->report_mtx, NULL);
+    pthread_cond_init(&g->report_cond, &ca);
+    pthread_condattr_destroy(&ca);
+    g->report_batch.count = 0;
+    g->report_stop = 0;
+    if (shm->clock.virtual_time)
+    {
+        g->report_task = (task_t){.fn = report_flush_step, .arg = g};
+        g->report_armed = 0;
+        return;
+    }
+    if (pthread_create(&g->report_flusher, NULL, report_flusher_thread, g) != 0)
+    {
+        perror("pthread_create report flusher");
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void report_batcher_stop(gang_ctx_t *g)
+{
+    pthread_mutex_lock(&g->report_mtx);
+    g->report_stop = 1;
+    pthread_cond_signal(&g->report_cond);
+    while (g->report_armed) // virtual time: the last batch leaves on its deadline
+        pthread_cond_wait(&g->report_cond, &g->report_mtx);
+    pthread_mutex_unlock(&g->report_mtx);
+    if (!shm->clock.virtual_time)
+        pthread_join(g->report_flusher, NULL);
+    pthread_cond_destroy(&g->report_cond);
+    pthread_mutex_destroy(&g->report_mtx);
+}
+
+// ───── Member event handlers ─────
+// Forward the member's newest intel to subordinates (true or misinfo,
+// depending on their credibility) and to same-rank peers.
+static void member_spread_intel(thread_args_t *ta)
+{
+    gang_ctx_t *g = ta->gang;
+    int me = ta->id;
+    int nsub = g->sub_count[me];
+    for (int si = 0; si < nsub; si++)
+    {
+        int sub_id = g->subordinates[me][si];
+        //////////////////////////////////////////  double base_true = ta->send_prob; //__Talin THU
+        // scale so that high-credibility folks almost never lie,
+        // low-cred folks lie a lot more(must be tied to each mission)
+        thread_args_t *target = &g->member_args[sub_id]; // however you reference it
+        double cred_t = target->credibility;
+        double max_false = shm->cfg.false_information_probability; // in config.h config
+        // probability of lying to low-cred folks is higher:
+        double p_false = max_false * (1.0 - cred_t);
+        // probability of truth to trusted folks:
+        double p_true = CLAMP(shm->cfg.info_spread_factor * cred_t,
+                              0.0, 1.0);
+        // ensure they don’t exceed 100%:
+        if (p_true + p_false > 1.0)
+            p_false = 1.0 - p_true;
+        double r = rng_unit(&ta->rng);
+        LOG(LOG_TRACE, "Member[%d]: r=%.2f, p_true=%.2f, p_false=%.2f\n",
+                       me, r, p_true, p_false);
+        if (r < p_true && ta->has_new_intel)
         {
-            sleep(1);
-            double r = rand() / (double)RAND_MAX;
-            if (r < shm->cfg.kill_rate)
-            {
-                printf("☠ Leader[%d] was killed during mission!\n", ta->id);
-                ta->is_dead = 1;
-                pthread_exit(NULL);
-            }
+            send_message(g, me, sub_id, ta->last_intel);
+            LOG(LOG_DEBUG, "✉  Manager[%d] → Member[%d]: \"%s\"\n",
+                           me, sub_id, intel_text(&shm->cfg, ta->last_intel));
+            ta->has_new_intel = 0;
+        }
+        //--Talin THU
+        else if (r < p_true + p_false && ta->has_new_intel)
+        {
+            // pick a random crime
+            int crime_i = rng_below(&ta->rng, shm->cfg.num_crimes);
+            Crime *crime = &shm->cfg.crimes[crime_i];
+
+            // sanity: skip if that crime has no intel entries
+            if (crime->legit_prep_intel_count <= 0)
+                return; ///////////////////////////////////////////////////////ADDEDDDD 2:28PM fRI
+
+            // pick a random intel entry from that crime
+            int intel_i = rng_below(&ta->rng, crime->legit_prep_intel_count);
+            // send it
+            send_message(g, me, sub_id, INTEL_CODE(crime_i, intel_i));
+            // pick a false string here
+            LOG(LOG_DEBUG, "⚠ Manager[%d] → Member[%d] (MISINFO)%s\n", me, sub_id,
+                           crime->legit_prep_intel[intel_i]);
+            ta->has_new_intel = 0;
         }
-        pthread_barrier_wait(ta->barrier);
-        printf("\U0001F3C1 Leader[%d] mission complete, waiting at barrier…\n", ta->id);
-        fflush(stdout);
-        if (arrested)
+    }
+    //__Talin FRI peer communication
+    // ——— peer communication ———
+    for (int pi = 0; pi < ta->peer_count; pi++)
+    {
+        int peer_id = ta->peers[pi];
+        double r = rng_unit(&ta->rng);
+        if (r < ta->peer_prob && ta->has_new_intel)
         {
-            int suspected_agent_thread_id = analyze_distribution_log(member_args, NUM_MEMBERS, ta->id);
-            printf("\U0001F6A8 Leader[%d] arrested suspected agent thread %d\n", ta->id, suspected_agent_thread_id);
-            pthread_cancel(members[suspected_agent_thread_id]);
-            // and (optionally) reap it right away
-            pthread_join(members[suspected_agent_thread_id], NULL);
-            printf("✅ Killed thread %d\n", suspected_agent_thread_id);
-            arrested = 0; // reset for next mission
+            // share your newest intel
+            intel_code_t intel = ta->last_intel;
+            send_message(g, ta->id, peer_id, intel);
+            LOG(LOG_DEBUG, "🔄 Member[%d] ↔ Member[%d]: “%s”\n", ta->id, peer_id,
+                           intel_text(&shm->cfg, intel));
+            ta->has_new_intel = 0;
         }
+    }
+}
+
+// Absorb one incoming message. Returns 1 if it was new intel.
+static int member_take_intel(thread_args_t *ta, const message_t *incoming)
+{
+    if (incoming->intel >= MAX_INTEL_CODES || !intel_set_add(&ta->intel_seen, incoming->intel))
+        return 0;
+
+    // ----- edited by mayar
+    ta->last_intel = incoming->intel;
+    ta->intel_count++;
+    LOG(LOG_DEBUG, "📬 Member[%d] received intel: “%s”\n", ta->id,
+                   intel_text(&shm->cfg, incoming->intel));
+    ta->has_new_intel = 1;
+    ta->prep_level++;
+    gang_set_prep_level(shm, ta->gang_id, ta->id, ta->prep_level); //// added new mayar
 
+    if (ta->prep_level >= 4 && !ta->is_ready)
+    {
+        ta->is_ready = 1;
+        LOG(LOG_INFO, "🎯 Member[%d] is now READY with 4 pieces of intel!\n", ta->id);
     }
-    return NULL;
+    else
+    {
+        LOG(LOG_DEBUG, "📈 Member[%d] prep level increased to %d\n", ta->id, ta->prep_level);
+    }
+    return 1;
 }
 
-void *member_thread(void *arg)
+// ADDED HALA: agent handles new intel + update crime knowledge
+static void member_report_intel(thread_args_t *ta)
+{
+    intel_code_t reported_intel = ta->last_intel;
+    const char *reported_text = intel_text(&shm->cfg, reported_intel);
+
+    // ADDED HALA: agent updates crime-specific knowledge
+    // the intel code already names the crime it belongs to
+    int ci = INTEL_CODE_CRIME(reported_intel);
+    if (ci < shm->cfg.num_crimes)
+    {
+        Crime *crime = &shm->cfg.crimes[ci];
+        // 0.1 per known snippet of this crime, capped at 1.0
+        int known = intel_set_count_crime(&ta->intel_seen, ci);
+        ta->crime_knowledge[ci] = known >= 10 ? 1.0f : 0.1f * known;
+
+        // ✅ This is the print statement you want:
+        LOG(LOG_DEBUG, "✅ Agent[%d] received correct intel: \"%s\" → Matched crime: \"%s\" → Knowledge now = %.2f\n",
+                       ta->id, reported_text, crime->name, ta->crime_knowledge[ci]);
+    }
+
+    // const char *correctness = ta->trusted ? "\u2705 (Correct)" : "\u274C (Wrong)";
+    LOG(LOG_INFO, "\U0001F575‍♂ Agent Member[%d] from Gang[%d] reported intel: \"%s\" \n",
+                  ta->id, ta->gang_id, reported_text);
+
+    police_report_t report = {
+        .gang_id = ta->gang_id,
+        .member_id = ta->id,
+        .intel = reported_intel,
+        .confidence = ta->credibility,
+    };
+
+    report_submit(ta->gang, &report);
+    LOG(LOG_DEBUG, "📨 Agent Member[%d] queued report for the police (conf=%.2f).\n",
+                   ta->id, ta->credibility);
+}
+
+// Absorb everything waiting in the inbox (after `first`, if given) and
+// let agents report what was new.
+static void member_drain_inbox(thread_args_t *ta, const message_t *first)
+{
+    message_t incoming;
+    int fresh = 0;
+    if (first)
+        fresh |= member_take_intel(ta, first);
+    while (!ta->is_ready && try_receive_message(ta->gang, ta->id, &incoming))
+    {
+        fresh |= member_take_intel(ta, &incoming);
+    }
+    if (fresh && ta->is_agent)
+        member_report_intel(ta);
+}
+
+// Work done at every prep-tick boundary
+static void member_tick(thread_args_t *ta, int tick)
+{
+    // hala start add***************************************************************************************
+    // double r = rand() / (double)RAND_MAX;
+    // if (r < shm->cfg.kill_rate)
+    // {
+    //     printf("☠ Member[%d] was killed during mission!\n", ta->id);
+    //     ta->is_dead = 1;
+    //     pthread_exit(NULL);
+    // }
+    LOG(LOG_DEBUG, "\u2699 Member[%d] from Gang[%d] (Rank=%d) prep tick %d/%d\n",
+                   ta->id, ta->gang_id, ta->rank, tick, ta->prep_ticks);
+
+    // nothing to pass on this tick → no work at all
+    if (ta->has_new_intel)
+        member_spread_intel(ta);
+}
+
+static void member_begin(thread_args_t *ta)
 {
-    thread_args_t *ta = arg;
-    strncpy(ta->pq->name, POLICE_QUEUE_NAME, sizeof(ta->pq->name) - 1);
-    ta->pq->name[sizeof(ta->pq->name) - 1] = '\0'; // Ensure null-termination
-    ta->pq->msg_size = sizeof(police_report_t);
-    ta->pq->mq = 3;
     const char *emoji = ta->is_agent ? "\U0001F575" : "\U0001F91D";
     // const char *trust_info = ta->trusted ? "\U0001F9E0 Trusted Info" : "\U0001F925 Misled";
     const char *crown = (ta->id == ta->leader_id) ? " \U0001F451 Leader" : "";
     // e.g. their existing “send_prob”
 
     //// added new mayar
-    sem_wait(&shm->sem_gang[ta->gang_id]);
-    shm->gang_ranks[ta->gang_id][ta->id] = ta->rank;
-    shm->gang_prep_levels[ta->gang_id][ta->id] = ta->prep_level;
-    sem_post(&shm->sem_gang[ta->gang_id]);
+    gang_set_member(shm, ta->gang_id, ta->id, ta->rank, ta->prep_level);
     /////
 
-    printf("%s Member[%d] from Gang[%d] ready and waiting… (TID=%lu, Rank=%d)has started with credibility %f %s\n",
-           emoji, ta->id, ta->gang_id, (unsigned long)pthread_self(), ta->rank, ta->credibility, crown);
-    fflush(stdout);
+    LOG(LOG_INFO, "%s Member[%d] from Gang[%d] ready and waiting… (TID=%lu, Rank=%d)has started with credibility %f %s\n",
+                  emoji, ta->id, ta->gang_id, (unsigned long)pthread_self(), ta->rank, ta->credibility, crown);
+}
+
+// After the last prep tick: settle credibility for this mission
+static void member_finish_prep(thread_args_t *ta)
+{
+    // if (ta->intel_count > 0)
+    //     ta->credibility += 0.05;
+    // else
+    //     ta->credibility -= 0.03;
+
+    double rank_norm = (double)ta->rank / (double)shm->cfg.ranking_levels;
+    int mission_intel_count = ta->gang->mission_intel_count;
+    double perf_norm = (mission_intel_count > 0)
+                           ? (double)ta->intel_count / (double)mission_intel_count
+                           : 0.0;
+    double luck = (rng_unit(&ta->rng) - 0.5) * LUCK_COEFF;
+    double delta = RANK_COEFF * rank_norm + PERF_COEFF * perf_norm + luck;
+    ta->credibility = CLAMP(ta->credibility + delta, CRED_MIN, CRED_MAX);
+
+    LOG(LOG_INFO, "📈 Member[%d] credibility after mission: %.2f\n", ta->id, ta->credibility);
+
+    // ADDED HALA: print full crime knowledge for agents
+    if (ta->is_agent)
+    {
+        LOG(LOG_INFO, "📊 Agent[%d] knowledge summary:\n", ta->id);
+        for (int ci = 0; ci < shm->cfg.num_crimes; ci++)
+        {
+            LOG(LOG_INFO, "   🔍 %s → %.2f\n", shm->cfg.crimes[ci].name, ta->crime_knowledge[ci]);
+        }
+    }
+
+    LOG(LOG_DEBUG, "\u2705 Member[%d] prep done, waiting at barrier…\n", ta->id);
+}
+
+// A member killed or executed leaves the gang at its next barrier, so
+// the remaining participants are never left waiting for it.
+static int member_still_in(thread_args_t *ta)
+{
+    if (!ta->is_dead)
+        return 1;
+    task_barrier_drop(ta->barrier);
+    return 0;
+}
+
+void *member_thread(void *arg)
+{
+    thread_args_t *ta = arg;
+    member_self = ta;
+    member_begin(ta);
     for (int mission_num = 1; mission_num <= shm->cfg.num_missions; mission_num++)
     {
-        printf("🚀member %d gang [%d] Starting Mission #%d\n", ta->id, ta->gang_id, mission_num);
+        if (!member_still_in(ta))
+            return NULL;
+        LOG(LOG_DEBUG, "🚀member %d gang [%d] Starting Mission #%d\n", ta->id, ta->gang_id, mission_num);
 
-        pthread_barrier_wait(ta->barrier);
+        task_barrier_wait(ta->barrier);
 
+        // Event-driven prep: block on the inbox until intel arrives or the
+        // next tick boundary passes, instead of waking every interval.
+        struct timespec next_tick;
+        sim_now(&shm->clock, &next_tick);
         for (int tick = 1; tick <= ta->prep_ticks; tick++)
         {
-            if (arrested){
-                continue;
-            }
-            ////////////////////////////////////////// double base_true = ta->send_prob; //__Talin THU
-            usleep(ta->prep_interval_us);
-            // hala start add***************************************************************************************
-            // double r = rand() / (double)RAND_MAX;
-            // if (r < shm->cfg.kill_rate)
-            // {
-            //     printf("☠ Member[%d] was killed during mission!\n", ta->id);
-            //     ta->is_dead = 1;
-            //     pthread_exit(NULL);
-            // }
-            printf("\u2699 Member[%d] from Gang[%d] (Rank=%d) prep tick %d/%d\n",
-                   ta->id, ta->gang_id, ta->rank, tick, ta->prep_ticks);
-            fflush(stdout);
-
-            int me = ta->id;
-            int nsub = sub_count[me];
-            for (int si = 0; si < nsub; si++)
+            if (ta->freeze)
             {
-                int sub_id = subordinates[me][si];
-                //////////////////////////////////////////  double base_true = ta->send_prob; //__Talin THU
-                // scale so that high-credibility folks almost never lie,
-                // low-cred folks lie a lot more(must be tied to each mission)
-                thread_args_t *target = &member_args[sub_id]; // however you reference it
-                double cred_t = target->credibility;
-                double max_false = shm->cfg.false_information_probability; // in config.h config
-                // probability of lying to low-cred folks is higher:
-                double p_false = max_false * (1.0 - cred_t);
-                // probability of truth to trusted folks:
-                double p_true = CLAMP(shm->cfg.info_spread_factor * cred_t,
-                                      0.0, 1.0);
-                // ensure they don’t exceed 100%:
-                if (p_true + p_false > 1.0)
-                    p_false = 1.0 - p_true;
-                double r = rand() / (double)RAND_MAX;
-                printf("Member[%d]: r=%.2f, p_true=%.2f, p_false=%.2f\n",
-                       me, r, p_true, p_false);
-                if (r < p_true && ta->has_new_intel)
-                {
-                    send_message(me, sub_id, ta->intel_list[ta->intel_count - 1]);
-                    printf("✉  Manager[%d] → Member[%d]: \"%s\"\n",
-                           me, sub_id, ta->intel_list[ta->intel_count - 1]);
-                    fflush(stdout);
-                    ta->has_new_intel = 0;
-                }
-                //--Talin THU
-                else if (r < p_true + p_false && ta->has_new_intel)
-                {
-                    // pick a random crime
-                    int crime_i = rand() % shm->cfg.num_crimes;
-                    Crime *crime = &shm->cfg.crimes[crime_i];
-
-                    // sanity: skip if that crime has no intel entries
-                    if (crime->legit_prep_intel_count <= 0)
-                        return NULL; ///////////////////////////////////////////////////////ADDEDDDD 2:28PM fRI
-
-                    // pick a random intel entry from that crime
-                    int intel_i = rand() % crime->legit_prep_intel_count;
-                    const char *misinfo = crime->legit_prep_intel[intel_i];
-
-                    // send it
-                    send_message(me, sub_id, misinfo);
-                    // pick a false string here
-                    printf("⚠ Manager[%d] → Member[%d] (MISINFO)%s\n", me, sub_id, misinfo);
-                    ta->has_new_intel = 0;
-                }
+                // arrested (SIGUSR2): hold this member for a while
+                ta->freeze = 0;
+                LOG(LOG_INFO, "🐌 Thread %lu got SIGUSR2 — sleeping 15s…\n",
+                              (unsigned long)pthread_self());
+                sim_sleep(&shm->clock, 15);
+                LOG(LOG_INFO, "🏃 Thread %lu resuming\n",
+                              (unsigned long)pthread_self());
+                sim_now(&shm->clock, &next_tick);
             }
-            //__Talin FRI peer communication
-            // ——— peer communication ———
-            for (int pi = 0; pi < ta->peer_count; pi++)
-            {
-                int peer_id = ta->peers[pi];
-                double r = rand() / (double)RAND_MAX;
-                if (r < ta->peer_prob && ta->has_new_intel)
-                {
-                    // share your newest intel
-                    const char *intel = ta->intel_list[ta->intel_count - 1];
-                    send_message(ta->id, peer_id, intel);
-                    printf("🔄 Member[%d] ↔ Member[%d]: “%s”\n", ta->id, peer_id, intel);
-                    fflush(stdout);
-                    ta->has_new_intel = 0;
-                }
+            if (ta->gang->arrested || ta->is_dead){
+                continue;
             }
-            // ta->has_new_intel = 0; ############################################################################كارثة
+            timespec_add_us(&next_tick, ta->prep_interval_us);
 
             message_t incoming;
-            while (try_receive_message(ta->id, &incoming))
-            {
-                int seen = 0;
-                for (int i = 0; i < ta->intel_count; i++)
-                    if (strcmp(ta->intel_list[i], incoming.text) == 0)
-                    {
-                        seen = 1;
-                        break;
-                    }
-                if (!seen && ta->intel_count < MAX_INTELS_PER_THREAD)
-                { // ----- edited by mayar
-                    ta->intel_list[ta->intel_count++] = strdup(incoming.text);
-                    printf("📬 Member[%d] received intel: “%s”\n", ta->id, incoming.text);
-                    ta->has_new_intel = 1;
-                    ta->prep_level++;
-                    sem_wait(&shm->sem_gang[ta->gang_id]); //// added new mayar
-                    shm->gang_prep_levels[ta->gang_id][ta->id] = ta->prep_level;
-                    sem_post(&shm->sem_gang[ta->gang_id]); ////
-
-                    if (ta->prep_level >= 4 && !ta->is_ready)
-                    {
-                        ta->is_ready = 1;
-                        printf("🎯 Member[%d] is now READY with 4 pieces of intel!\n", ta->id);
-                        fflush(stdout);
-                        break;
-                    }
-                    else
-                    {
-                        printf("📈 Member[%d] prep level increased to %d\n", ta->id, ta->prep_level);
-                    }
-                }
-            }
+            while (timed_receive_message(ta->gang, ta->id, &incoming, &next_tick))
+                member_drain_inbox(ta, &incoming);
+            member_tick(ta, tick);
+        }
 
-            // ADDED HALA: agent handles new intel + update crime knowledge
-            if (ta->is_agent && ta->has_new_intel)
-            {
-                const char *reported_intel = ta->intel_list[ta->intel_count - 1];
+        member_finish_prep(ta);
+        if (!member_still_in(ta))
+            return NULL;
+        // befor mission wait ____________________________________________-Talin FRI
+        task_barrier_wait(ta->barrier);
+        // starting mission ____________________________________________-Talin FRI
+        LOG(LOG_DEBUG, "\U0001F3C1 Member[%d] starting mission (duration=%ds)…\n", ta->id, ta->mission_duration_s);
+        if (!member_still_in(ta))
+            return NULL;
+        task_barrier_wait(ta->barrier);
+        LOG(LOG_DEBUG, "\U0001F3C6 Member[%d] mission complete…\n", ta->id);
+    }
+    return NULL;
+}
 
-                // ADDED HALA: agent updates crime-specific knowledge
+// ───── Member as an executor task ─────
+// The same mission loop as member_thread(), unrolled into resumable
+// steps: barriers park the task and prep ticks are timer wake-ups, so a
+// fixed worker pool can drive every member of the gang.
+typedef enum
+{
+    MS_BEGIN,        // before the start-of-mission barrier
+    MS_PREP_START,   // released into preparation
+    MS_PREP_TICK,    // woken at a tick boundary
+    MS_PREP_DONE,    // before the pre-mission barrier
+    MS_MISSION_RUN,  // before the end-of-mission barrier
+    MS_MISSION_END   // mission finished, loop to the next one
+} member_state_t;
+
+typedef struct
+{
+    task_t task;
+    thread_args_t *ta;
+    member_state_t state;
+    int mission_num;
+    int tick;
+} member_task_t;
+
+// Last step of a member or leader task; lets gang_main() know once all are gone.
+static task_status_t task_exit(thread_args_t *ta)
+{
+    gang_ctx_t *g = ta->gang;
+    pthread_mutex_lock(&g->tasks_mtx);
+    if (--g->tasks_running == 0)
+        pthread_cond_signal(&g->tasks_done);
+    pthread_mutex_unlock(&g->tasks_mtx);
+    return TASK_DONE;
+}
 
-                for (int ci = 0; ci < shm->cfg.num_crimes; ci++)
-                {
-                    // check if the intel matches any legit intel of this crime
-                    Crime *crime = &shm->cfg.crimes[ci];
-                    for (int j = 0; j < crime->legit_prep_intel_count; j++)
-                    {
-                        if (strcmp(reported_intel, crime->legit_prep_intel[j]) == 0)
-                        {
-                            ta->crime_knowledge[ci] += 0.1f;
-                            if (ta->crime_knowledge[ci] > 1.0f)
-                                ta->crime_knowledge[ci] = 1.0f;
-
-                            // ✅ This is the print statement you want:
-                            printf("✅ Agent[%d] received correct intel: \"%s\" → Matched crime: \"%s\" → Knowledge now = %.2f\n",
-                                   ta->id, reported_intel, crime->name, ta->crime_knowledge[ci]);
-                            fflush(stdout);
-                            break;
-                        }
-                    }
-                }
+static task_status_t member_park(member_task_t *mt, member_state_t next)
+{
+    if (!member_still_in(mt->ta))
+        return task_exit(mt->ta);
+    mt->state = next;
+    mt->task.park_on = mt->ta->barrier;
+    return TASK_PARKED;
+}
 
-                // const char *correctness = ta->trusted ? "\u2705 (Correct)" : "\u274C (Wrong)";
-                printf("\U0001F575‍♂ Agent Member[%d] from Gang[%d] reported intel: \"%s\" \n",
-                       ta->id, ta->gang_id, reported_intel);
-                fflush(stdout);
-
-                police_report_t report = {
-                    .gang_id = ta->gang_id,
-                    .member_id = ta->id,
-                    .confidence = ta->credibility,
-                };
-                // copy the mission text
-                strncpy(report.mission, reported_intel, sizeof(report.mission) - 1);
-                report.mission[sizeof(report.mission) - 1] = '\0';
-
-                if (pq_send(ta->pq, &report) == -1)
-                {
-                    perror("❌ Failed to send report to police queue");
-                }
-                else
-                {
-                    printf("📨 Agent Member[%d] sent report to police queue (conf=%.2f).\n",
-                           ta->id);
-                }
+static task_status_t member_step(task_t *t)
+{
+    member_task_t *mt = t->arg;
+    thread_args_t *ta = mt->ta;
+    task_sender = ta;
+    flush_blocked_sends(ta);
+
+    for (;;)
+    {
+        switch (mt->state)
+        {
+        case MS_BEGIN:
+            if (mt->mission_num == 0)
+            {
+                member_begin(ta);
+                mt->mission_num = 1;
             }
-            if (tick == ta->prep_ticks)
+            if (mt->mission_num > shm->cfg.num_missions)
+                return task_exit(mt->ta);
+            LOG(LOG_DEBUG, "🚀member %d gang [%d] Starting Mission #%d\n", ta->id, ta->gang_id, mt->mission_num);
+            return member_park(mt, MS_PREP_START);
+
+        case MS_PREP_START:
+            mt->tick = 0;
+            executor_now(t->ex, &t->wake_at);
+            timespec_add_us(&t->wake_at, ta->prep_interval_us);
+            mt->state = MS_PREP_TICK;
+            return TASK_SLEEP;
+
+        case MS_PREP_TICK:
+            if (ta->freeze)
             {
-                break;
+                // arrested: hold this member for a while, like SIGUSR2 does
+                ta->freeze = 0;
+                executor_now(t->ex, &t->wake_at);
+                t->wake_at.tv_sec += 15;
+                return TASK_SLEEP;
             }
+            mt->tick++;
+            if (!ta->gang->arrested && !ta->is_dead)
+            {
+                member_drain_inbox(ta, NULL);
+                member_tick(ta, mt->tick);
+            }
+            if (mt->tick < ta->prep_ticks)
+            {
+                if (ta->gang->arrested || ta->is_dead)
+                    return TASK_YIELD; // skip ahead, as the thread loop does
+                timespec_add_us(&t->wake_at, ta->prep_interval_us);
+                return TASK_SLEEP;
+            }
+            mt->state = MS_PREP_DONE;
+            break;
+
+        case MS_PREP_DONE:
+            member_finish_prep(ta);
+            return member_park(mt, MS_MISSION_RUN);
+
+        case MS_MISSION_RUN:
+            LOG(LOG_DEBUG, "\U0001F3C1 Member[%d] starting mission (duration=%ds)…\n", ta->id, ta->mission_duration_s);
+            return member_park(mt, MS_MISSION_END);
+
+        case MS_MISSION_END:
+            LOG(LOG_DEBUG, "\U0001F3C6 Member[%d] mission complete…\n", ta->id);
+            mt->mission_num++;
+            mt->state = MS_BEGIN;
+            break;
         }
+    }
+}
 
-        // if (ta->intel_count > 0)
-        //     ta->credibility += 0.05;
-        // else
-        //     ta->credibility -= 0.03;
-
-        double rank_norm = (double)ta->rank / (double)shm->cfg.ranking_levels;
-        double perf_norm = (mission_intel_count > 0)
-                               ? (double)ta->intel_count / (double)mission_intel_count
-                               : 0.0;
-        double luck = ((double)rand() / RAND_MAX - 0.5) * LUCK_COEFF;
-        double delta = RANK_COEFF * rank_norm + PERF_COEFF * perf_norm + luck;
-        ta->credibility = CLAMP(ta->credibility + delta, CRED_MIN, CRED_MAX);
+// ───── Leader as an executor task ─────
+// leader_thread() unrolled the same way, so that with clock_mode
+// "virtual" every tick and mission second of the gang is a timer event.
+typedef enum
+{
+    LS_BEGIN,           // pick the next mission, then the start barrier
+    LS_PREP_START,      // released into preparation
+    LS_PREP_TICK,       // woken at a tick boundary
+    LS_MISSION_START,   // released into the mission
+    LS_MISSION_SECOND,  // woken once per mission second
+    LS_MISSION_END      // released after the mission
+} leader_state_t;
+
+typedef struct
+{
+    task_t task;
+    thread_args_t *ta;
+    leader_state_t state;
+    int mission_num;
+    int tick;
+    int sec;
+    leader_mission_t lm;
+} leader_task_t;
+
+static task_status_t leader_park(leader_task_t *lt, leader_state_t next)
+{
+    lt->state = next;
+    lt->task.park_on = lt->ta->barrier;
+    return TASK_PARKED;
+}
 
-        printf("📈 Member[%d] credibility after mission: %.2f\n", ta->id, ta->credibility);
+static task_status_t leader_step(task_t *t)
+{
+    leader_task_t *lt = t->arg;
+    thread_args_t *ta = lt->ta;
+    task_sender = ta;
+    flush_blocked_sends(ta);
 
-        // ADDED HALA: print full crime knowledge for agents
-        if (ta->is_agent)
+    for (;;)
+    {
+        switch (lt->state)
         {
-            printf("📊 Agent[%d] knowledge summary:\n", ta->id);
-            for (int ci = 0; ci < shm->cfg.num_crimes; ci++)
+        case LS_BEGIN:
+            if (lt->mission_num == 0)
             {
-                printf("   🔍 %s → %.2f\n", shm->cfg.crimes[ci].name, ta->crime_knowledge[ci]);
+                leader_begin(ta);
+                lt->mission_num = 1;
             }
-        }
+            if (lt->mission_num > shm->cfg.num_missions)
+                return task_exit(ta);
+            leader_begin_mission(ta, &lt->lm, lt->mission_num);
+            return leader_park(lt, LS_PREP_START);
+
+        case LS_PREP_START:
+            lt->tick = 0;
+            executor_now(t->ex, &t->wake_at);
+            timespec_add_us(&t->wake_at, ta->prep_interval_us);
+            lt->state = LS_PREP_TICK;
+            return TASK_SLEEP;
+
+        case LS_PREP_TICK:
+            leader_prep_tick(ta, &lt->lm, ++lt->tick);
+            if (lt->tick < ta->prep_ticks)
+            {
+                timespec_add_us(&t->wake_at, ta->prep_interval_us);
+                return TASK_SLEEP;
+            }
+            return leader_park(lt, LS_MISSION_START);
+
+        case LS_MISSION_START:
+            LOG(LOG_INFO, "\U0001F680 Leader[%d] starting mission (duration=%ds)…\n", ta->id, ta->mission_duration_s);
+            lt->sec = 0;
+            if (ta->mission_duration_s <= 0)
+                return leader_park(lt, LS_MISSION_END);
+            executor_now(t->ex, &t->wake_at);
+            t->wake_at.tv_sec += 1;
+            lt->state = LS_MISSION_SECOND;
+            return TASK_SLEEP;
+
+        case LS_MISSION_SECOND:
+            // simulate death during mission
+            if (leader_mission_second(ta))
+            {
+                task_barrier_drop(ta->barrier); // leaves the barrier, as the thread does
+                return task_exit(ta);
+            }
+            if (++lt->sec < ta->mission_duration_s)
+            {
+                t->wake_at.tv_sec += 1;
+                return TASK_SLEEP;
+            }
+            return leader_park(lt, LS_MISSION_END);
 
-        printf("\u2705 Member[%d] prep done, waiting at barrier…\n", ta->id);
-        fflush(stdout);
-        // befor mission wait ____________________________________________-Talin FRI
-        pthread_barrier_wait(ta->barrier);
-        // starting mission ____________________________________________-Talin FRI
-        printf("\U0001F3C1 Member[%d] starting mission (duration=%ds)…\n", ta->id, ta->mission_duration_s);
-        fflush(stdout);
-        pthread_barrier_wait(ta->barrier);
-        printf("\U0001F3C6 Member[%d] mission complete…\n", ta->id);
+        case LS_MISSION_END:
+            leader_end_mission(ta);
+            lt->mission_num++;
+            lt->state = LS_BEGIN;
+            break;
+        }
     }
-    return NULL;
 }
 
 void print_rank_histogram(int *ranks, int count)
@@ -651,19 +1325,19 @@ void print_rank_histogram(int *ranks, int count)
     for (int i = 0; i < count; i++)
         histogram[ranks[i]]++;
 
-    printf("\U0001F4CA Rank Distribution:\n");
+    LOG(LOG_INFO, "\U0001F4CA Rank Distribution:\n");
     for (int r = 0; r <= 10; r++)
     {
         if (histogram[r] > 0)
-            printf("\U0001F538 Rank %d: %d member(s)\n", r, histogram[r]);
+            LOG(LOG_INFO, "\U0001F538 Rank %d: %d member(s)\n", r, histogram[r]);
     }
-    printf("\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\n");
+    LOG(LOG_INFO, "\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\u2014\n");
 }
 
-void assign_rank_distribution(int *ranks, int num_members, int *leader_rank_out, int *leader_id_out)
+void assign_rank_distribution(rng_t *rng, int *ranks, int num_members, int *leader_rank_out, int *leader_id_out)
 {
     int ranking_levels = shm->cfg.ranking_levels;
-    int leader_index = rand() % num_members;
+    int leader_index = rng_below(rng, num_members);
     *leader_rank_out = ranking_levels;
     *leader_id_out = leader_index;
     ranks[leader_index] = ranking_levels;
@@ -673,7 +1347,7 @@ void assign_rank_distribution(int *ranks, int num_members, int *leader_rank_out,
     {
         if (i == leader_index)
             continue;
-        int rank = rand() % ranking_levels;
+        int rank = rng_below(rng, ranking_levels);
         ranks[i] = rank;
         filled++;
     }
@@ -681,145 +1355,233 @@ void assign_rank_distribution(int *ranks, int num_members, int *leader_rank_out,
     print_rank_histogram(ranks, num_members);
 }
 
-void send_message(int from_id, int to_id, const char *text)
-{
-    msg_queue_t *q = &queues[to_id];
-    pthread_mutex_lock(&q->mtx);
-
-    // maybe resize if full…
-    int idx = q->tail % q->capacity;
-    q->fifo[idx].from_id = from_id;
-    q->fifo[idx].timestamp = time(NULL);
-    strncpy(q->fifo[idx].text, text, sizeof(q->fifo[idx].text) - 1);
-    q->tail++;
-    record_transmission(text, from_id, to_id); // record the transmission
-    // log it
-    // FILE *logf = fopen("distribution.log", "a");
-    // fprintf(logf, "%ld Thread[%d] -> Thread[%d]: \"%s\"\n",
-    //         q->fifo[idx].timestamp, from_id, to_id, text);
-    // fclose(logf);
-
-    pthread_cond_signal(&q->cond);
-    pthread_mutex_unlock(&q->mtx);
-}
+// ───── Blocked sends in task context ─────
+// A task must not sleep on its worker (with one worker the receiver could
+// never run), so under QUEUE_BLOCK it parks the message here and retries
+// at each of its later steps until ipc_timeout_ms has passed.
+#define SEND_BACKLOG 16
 
-message_t receive_message(int my_id)
+typedef struct send_backlog
 {
-    msg_queue_t *q = &queues[my_id];
-    pthread_mutex_lock(&q->mtx);
-    while (q->head == q->tail)
-        pthread_cond_wait(&q->cond, &q->mtx);
+    int count;
+    struct
+    {
+        message_t msg;
+        int to;
+        int64_t since_ns;
+    } slot[SEND_BACKLOG];
+} send_backlog_t;
 
-    message_t msg = q->fifo[q->head % q->capacity];
-    q->head++;
-    pthread_mutex_unlock(&q->mtx);
-    return msg;
+static int defer_send(thread_args_t *ta, int to_id, const message_t *msg, int64_t now_ns)
+{
+    if (!ta->backlog && !(ta->backlog = calloc(1, sizeof *ta->backlog)))
+        return 0;
+    send_backlog_t *b = ta->backlog;
+    if (b->count == SEND_BACKLOG)
+        return 0;
+    b->slot[b->count].msg = *msg;
+    b->slot[b->count].to = to_id;
+    b->slot[b->count].since_ns = now_ns;
+    b->count++;
+    return 1;
 }
 
-// returns true if a message was dequeued into *out, false if queue was empty
-int try_receive_message(int my_id, message_t *out)
+// Apply cfg.msg_queue_policy to a message that did not fit. Returns 1 if
+// it was eventually queued, 0 if it was dropped, -1 if it waits on the
+// sending task's backlog.
+static int send_on_full(gang_ctx_t *g, int to_id, const message_t *msg, int64_t now_ns)
 {
-    msg_queue_t *q = &queues[my_id];
-    pthread_mutex_lock(&q->mtx);
-    if (q->head == q->tail)
+    msg_queue_t *q = &g->queues[to_id];
+    atomic_fetch_add_explicit(q->overflow, 1, memory_order_relaxed);
+    switch (shm->cfg.msg_queue_policy)
     {
-        // nothing waiting
-        pthread_mutex_unlock(&q->mtx);
+    case QUEUE_DROP_OLDEST:
+    {
+        message_t stale;
+        do
+        {
+            // evict the oldest unread message; it is a drop, not a send
+            if (msgq_pop(q, &stale))
+            {
+                evlog_append(&event_log, now_ns, g->gang_id, stale.from_id, to_id, stale.intel, EV_DROP);
+                forget_transmission(g, stale.intel, stale.from_id, to_id, stale.timestamp);
+            }
+        } while (!msgq_push(q, msg));
+        return 1;
+    }
+    case QUEUE_BLOCK:
+    {
+        if (task_sender)
+            return defer_send(task_sender, to_id, msg, now_ns) ? -1 : 0;
+        // bounded back-pressure: wait for the receiver to drain a slot
+        int waited_ms = 0;
+        while (waited_ms < shm->cfg.ipc_timeout_ms)
+        {
+            sim_usleep(&shm->clock, 1000);
+            waited_ms++;
+            if (msgq_push(q, msg))
+                return 1;
+        }
         return 0;
     }
-    *out = q->fifo[q->head % q->capacity];
-    q->head++;
-    pthread_mutex_unlock(&q->mtx);
-    return 1;
+    default:
+        return 0; // QUEUE_DROP_NEWEST
+    }
 }
 
-int main(int argc, char *argv[])
+// Bookkeeping for a message that made it into member `to_id`'s queue
+static void message_sent(gang_ctx_t *g, int to_id, const message_t *msg, int64_t now_ns)
 {
-    printf("\U0001F3AC [GangProcess] Starting up...\n");
-
-    if (argc < 2)
+    msg_queue_t *q = &g->queues[to_id];
+    int from_id = msg->from_id;
+    intel_code_t intel = msg->intel;
+    // several senders race on the mark: keep it a monotonic max
+    uint32_t depth = (uint32_t)msgq_depth(q);
+    uint32_t hwm = atomic_load_explicit(q->hwm, memory_order_relaxed);
+    while (depth > hwm && !atomic_compare_exchange_weak_explicit(q->hwm, &hwm, depth, memory_order_relaxed,
+                                                                  memory_order_relaxed))
+        ;
+    record_transmission(g, intel, from_id, to_id, msg->timestamp); // record the transmission
+    // log it; distlog_decode renders the old distribution.log text
+    evlog_append(&event_log, now_ns, g->gang_id, from_id, to_id, intel, EV_SEND);
+
+    // wake the receiver only if it is parked in receive_message()
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&q->sleeping, memory_order_relaxed))
     {
-        fprintf(stderr, "\u274C Usage: %s <gang_id>\n", argv[0]);
-        return EXIT_FAILURE;
+        pthread_mutex_lock(&q->mtx);
+        pthread_cond_signal(&q->cond);
+        pthread_mutex_unlock(&q->mtx);
     }
+}
 
-    int gang_id = atoi(argv[1]);
-
-    // 🔄 Place srand BEFORE any call to rand()
-    srand((unsigned int)(time(NULL) ^ (uintptr_t)pthread_self()));
-
-    printf("\U0001F522 Parsed gang_id = %d\n", gang_id);
-    fflush(stdout);
+void send_message(gang_ctx_t *g, int from_id, int to_id, intel_code_t intel)
+{
+    msg_queue_t *q = &g->queues[to_id];
+    int64_t now_ns = gang_now_ns();
+    message_t msg = {
+        .from_id = from_id,
+        .timestamp = (time_t)(now_ns / 1000000000LL),
+        .intel = intel};
+
+    int queued = msgq_push(q, &msg) ? 1 : send_on_full(g, to_id, &msg, now_ns);
+    if (queued == 0)
+        evlog_append(&event_log, now_ns, g->gang_id, from_id, to_id, intel, EV_DROP);
+    else if (queued > 0)
+        message_sent(g, to_id, &msg, now_ns);
+    // queued < 0: retried from the sender's next step
+}
 
-    shm = shm_child_attach();
-    if (!shm)
+static void flush_blocked_sends(thread_args_t *ta)
+{
+    send_backlog_t *b = ta->backlog;
+    if (!b || b->count == 0)
+        return;
+    gang_ctx_t *g = ta->gang;
+    int64_t now_ns = gang_now_ns();
+    int64_t timeout_ns = shm->cfg.ipc_timeout_ms * 1000000LL;
+    int keep = 0;
+    for (int i = 0; i < b->count; i++)
     {
-        perror("\u274C shm_child_attach");
-        exit(EXIT_FAILURE);
+        if (msgq_push(&g->queues[b->slot[i].to], &b->slot[i].msg))
+            message_sent(g, b->slot[i].to, &b->slot[i].msg, now_ns);
+        else if (now_ns - b->slot[i].since_ns >= timeout_ns)
+            evlog_append(&event_log, now_ns, g->gang_id, b->slot[i].msg.from_id, b->slot[i].to,
+                         b->slot[i].msg.intel, EV_DROP);
+        else
+            b->slot[keep++] = b->slot[i];
     }
+    b->count = keep;
+}
 
-    // register signal handler for SIGUSR1
-    struct sigaction sa;
-    sa.sa_handler = handle_sigusr1;
-    sigemptyset(&sa.sa_mask);
-    sa.sa_flags = SA_RESTART; // so interrupted syscalls auto-restart
-    if (sigaction(SIGUSR1, &sa, NULL) < 0)
-    {
-        perror("sigaction(SIGUSR1)");
-        exit(EXIT_FAILURE);
-    }
-    struct sigaction sa2;
-    sa2.sa_handler = handle_sigusr2;
-    sigemptyset(&sa2.sa_mask);
-    sa2.sa_flags = SA_RESTART; // so interrupted syscalls auto-restart
-    if (sigaction(SIGUSR1, &sa2, NULL) < 0)
+// Dequeue into *out, parking on the queue's condvar until a message
+// arrives or the simulated CLOCK_MONOTONIC `deadline` (sim_now) passes
+// (NULL = wait forever). Returns 1 if a message was dequeued, 0 on timeout.
+int timed_receive_message(gang_ctx_t *g, int my_id, message_t *out, const struct timespec *deadline)
+{
+    msg_queue_t *q = &g->queues[my_id];
+    int timed_out = 0;
+    struct timespec real_deadline;
+    if (deadline)
+        sim_to_real(&shm->clock, deadline, &real_deadline);
+    while (!msgq_pop(q, out))
     {
-        perror("sigaction(SIGUSR2)");
-        exit(EXIT_FAILURE);
+        if (timed_out)
+            return 0;
+        pthread_mutex_lock(&q->mtx);
+        atomic_store(&q->sleeping, 1);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (msgq_depth(q) == 0)
+        {
+            if (deadline)
+                timed_out = pthread_cond_timedwait(&q->cond, &q->mtx, &real_deadline) == ETIMEDOUT;
+            else
+                pthread_cond_wait(&q->cond, &q->mtx);
+        }
+        atomic_store(&q->sleeping, 0);
+        pthread_mutex_unlock(&q->mtx);
     }
+    return 1;
+}
 
-    police_queue_t pq;
-    pq.mq = 3;
-    if (pq_open(&pq, POLICE_QUEUE_NAME) == -1)
-    {
-        perror("\u274C pq_open");
-        exit(EXIT_FAILURE);
-    }
-    printf("\U0001F4E2 Opened police queue:%s (mq=%d, msg_size=%zu)\n",
-           pq.name, (int)pq.mq, pq.msg_size);
-    fflush(stdout);
+message_t receive_message(gang_ctx_t *g, int my_id)
+{
+    message_t msg;
+    timed_receive_message(g, my_id, &msg, NULL);
+    return msg;
+}
+
+// returns true if a message was dequeued into *out, false if queue was empty
+int try_receive_message(gang_ctx_t *g, int my_id, message_t *out)
+{
+    return msgq_pop(&g->queues[my_id], out);
+}
+
+// One hosted gang, from member hiring to the post-mission rebuild
+static void *gang_main(void *arg)
+{
+    gang_ctx_t *g = arg;
+    int gang_id = g->gang_id;
     // __________________________________________________________________________________--talin FRI moved to global scope
     int min = shm->cfg.gang_members_min;
     int max = shm->cfg.gang_members_max;
-    NUM_MEMBERS = min + rand() % (max - min + 1);
-    sem_wait(&shm->sem_gang[gang_id]); /// added
-    shm->gang[gang_id].members_alive = NUM_MEMBERS;
-    sem_post(&shm->sem_gang[gang_id]);
+    // the gang's own stream; leader and members get theirs below
+    rng_seed(&g->rng, (uint64_t)shm->cfg.random_seed, gang_id, RNG_GANG_STREAM);
+    g->num_members = min + rng_below(&g->rng, max - min + 1);
+    gang_set_members_alive(shm, gang_id, g->num_members); /// added
+    for (int ci = 0; ci < shm->cfg.num_crimes; ci++)
+        for (int j = 0; j < shm->cfg.crimes[ci].legit_prep_intel_count; j++)
+            g->intel_db[INTEL_CODE(ci, j)].text = shm->cfg.crimes[ci].legit_prep_intel[j];
     // initialize inner queues_Talin SAT
-    queues = calloc(NUM_MEMBERS, sizeof(*queues));
-    for (int i = 0; i < NUM_MEMBERS; i++)
+    int queue_depth = shm->cfg.msg_queue_depth > 0 ? shm->cfg.msg_queue_depth : 16;
+    g->queues = calloc(g->num_members, sizeof(*g->queues));
+    for (int i = 0; i < g->num_members; i++)
     {
-        pthread_mutex_init(&queues[i].mtx, NULL);
-        pthread_cond_init(&queues[i].cond, NULL);
-        queues[i].capacity = 16; // or whatever
-        queues[i].fifo = malloc(sizeof(message_t) * 16);
-        queues[i].head = queues[i].tail = 0;
+        if (msgq_init(&g->queues[i], queue_depth) == -1)
+        {
+            perror("msgq_init");
+            exit(EXIT_FAILURE);
+        }
+        g->queues[i].overflow = &shm->per_gang[gang_id].queue_overflow[i];
+        g->queues[i].hwm = &shm->per_gang[gang_id].queue_hwm[i];
+        atomic_store(g->queues[i].overflow, 0);
+        atomic_store(g->queues[i].hwm, 0);
     }
 
-    printf("\U0001F465 Gang[%d] has %d members this round.\n", gang_id, NUM_MEMBERS);
-    printf("🎲 Randomly chosen number of members for Gang[%d]: %d (min=%d, max=%d)\n", gang_id, NUM_MEMBERS, min, max);
+    LOG(LOG_INFO, "\U0001F465 Gang[%d] has %d members this round.\n", gang_id, g->num_members);
+    LOG(LOG_INFO, "🎲 Randomly chosen number of members for Gang[%d]: %d (min=%d, max=%d)\n", gang_id, g->num_members, min, max);
 
     int PREP_TICKS = (int)(shm->cfg.required_prep_level * 10);
     int PREP_INTERVAL_US = (shm->cfg.preparation_time * 1000000) / PREP_TICKS;
     int MISSION_DURATION_S = shm->cfg.preparation_time;
 
-    int *ranks = malloc(NUM_MEMBERS * sizeof(int));
+    int *ranks = malloc(g->num_members * sizeof(int));
     int leader_rank, leader_id;
-    assign_rank_distribution(ranks, NUM_MEMBERS, &leader_rank, &leader_id);
+    assign_rank_distribution(&g->rng, ranks, g->num_members, &leader_rank, &leader_id);
 
     //_Assign Managers_Talin SAT
-    int *manager = malloc(sizeof(int) * NUM_MEMBERS);
-    for (int i = 0; i < NUM_MEMBERS; i++)
+    int *manager = malloc(sizeof(int) * g->num_members);
+    for (int i = 0; i < g->num_members; i++)
     {
         if (i == leader_id)
         {
@@ -829,7 +1591,7 @@ int main(int argc, char *argv[])
         {
             // find the “closest” higher-ranked thread
             int best = leader_id, best_rank = ranks[leader_id];
-            for (int j = 0; j < NUM_MEMBERS; j++)
+            for (int j = 0; j < g->num_members; j++)
             {
                 if (ranks[j] < ranks[i] && ranks[j] < best_rank)
                 {
@@ -839,54 +1601,55 @@ int main(int argc, char *argv[])
             }
             manager[i] = best;
         }
-        printf("Member[%d] (Rank=%d) → Manager = %s[%d]\n",
-               i, ranks[i],
-               (manager[i] >= 0 ? "Member" : "None"),
-               manager[i]);
+        LOG(LOG_INFO, "Member[%d] (Rank=%d) → Manager = %s[%d]\n",
+                      i, ranks[i],
+                      (manager[i] >= 0 ? "Member" : "None"),
+                      manager[i]);
     }
     //-Assignb Subordinates__Talin SAT
     // right after you fill manager[i] …
-    subordinates = calloc(NUM_MEMBERS, sizeof(int *));
-    sub_count = calloc(NUM_MEMBERS, sizeof(int));
+    g->subordinates = calloc(g->num_members, sizeof(int *));
+    g->sub_count = calloc(g->num_members, sizeof(int));
 
     // first pass: count how many under each
-    for (int i = 0; i < NUM_MEMBERS; i++)
+    for (int i = 0; i < g->num_members; i++)
     {
         int m = manager[i];
         if (m >= 0)
-            sub_count[m]++;
+            g->sub_count[m]++;
     }
 
     // allocate each list
-    for (int m = 0; m < NUM_MEMBERS; m++)
+    for (int m = 0; m < g->num_members; m++)
     {
-        if (sub_count[m] > 0)
-            subordinates[m] = malloc(sub_count[m] * sizeof(int));
-        sub_count[m] = 0; // reuse as “insertion index”
+        if (g->sub_count[m] > 0)
+            g->subordinates[m] = malloc(g->sub_count[m] * sizeof(int));
+        g->sub_count[m] = 0; // reuse as “insertion index”
     }
 
     // second pass: fill them
-    for (int i = 0; i < NUM_MEMBERS; i++)
+    for (int i = 0; i < g->num_members; i++)
     {
         int m = manager[i];
         if (m >= 0)
         {
-            subordinates[m][sub_count[m]++] = i;
+            g->subordinates[m][g->sub_count[m]++] = i;
         }
     }
-    for (int m = 0; m < NUM_MEMBERS; m++)
+    for (int m = 0; m < g->num_members; m++)
     {
-        if (sub_count[m] > 0)
+        if (g->sub_count[m] > 0)
         {
-            printf("Manager Member[%d] has %d subordinate(s):", m, sub_count[m]);
-            for (int si = 0; si < sub_count[m]; si++)
-                printf(" %d", subordinates[m][si]);
-            printf("\n");
+            char line[LOG_LINE_MAX];
+            int len = snprintf(line, sizeof line, "Manager Member[%d] has %d subordinate(s):", m, g->sub_count[m]);
+            for (int si = 0; si < g->sub_count[m] && len < (int)sizeof line; si++)
+                len += snprintf(line + len, sizeof line - len, " %d", g->subordinates[m][si]);
+            LOG(LOG_INFO, "%s\n", line);
         }
     }
     int max_rank = shm->cfg.ranking_levels;
     int *rank_count = calloc(max_rank + 1, sizeof(int));
-    for (int i = 0; i < NUM_MEMBERS; i++)
+    for (int i = 0; i < g->num_members; i++)
         rank_count[ranks[i]]++;
 
     // --- allocate arrays
@@ -899,7 +1662,7 @@ int main(int argc, char *argv[])
     }
 
     // --- fill them
-    for (int i = 0; i < NUM_MEMBERS; i++)
+    for (int i = 0; i < g->num_members; i++)
     {
         int r = ranks[i];
         rank_members[r][rank_count[r]++] = i;
@@ -909,14 +1672,22 @@ int main(int argc, char *argv[])
     {
         if (rank_count[r] > 1)
         {
-            printf("Rank %d peers:", r);
-            for (int j = 0; j < rank_count[r]; j++)
-                printf(" %d", rank_members[r][j]);
-            printf("\n");
+            char line[LOG_LINE_MAX];
+            int len = snprintf(line, sizeof line, "Rank %d peers:", r);
+            for (int j = 0; j < rank_count[r] && len < (int)sizeof line; j++)
+                len += snprintf(line + len, sizeof line - len, " %d", rank_members[r][j]);
+            LOG(LOG_INFO, "%s\n", line);
         }
     }
-    pthread_barrier_t mission_barrier;
-    pthread_barrier_init(&mission_barrier, NULL, NUM_MEMBERS); // +1 was changed to +2 !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+    pthread_mutex_init(&g->graph_mtx, NULL);
+    g->suspicion_count = calloc(g->num_members, sizeof(int));
+    g->suspect_intel = calloc(g->num_members, sizeof(intel_code_t));
+    g->graph_stack = malloc(g->num_members * sizeof(int));
+    g->most_suspected = -1;
+    report_batcher_start(g);
+
+    task_barrier_t mission_barrier;
+    task_barrier_init(&mission_barrier, g->num_members); // leader + every member
 
     pthread_t leader;
     thread_args_t leader_args = {
@@ -934,24 +1705,50 @@ int main(int argc, char *argv[])
         .is_agent = 0,
         .send_prob = 0.6,
         .credibility = 1,
-        .pq = &pq};
+        .pq = g->pq,
+        .gang = g};
 
-    pthread_create(&leader, NULL, leader_thread, &leader_args);
+    g->leader_id = leader_id;
+    rng_seed(&leader_args.rng, (uint64_t)shm->cfg.random_seed, gang_id, leader_id);
+    if (!member_pool)
+        pthread_create(&leader, NULL, leader_thread, &leader_args);
     //__Talin FRI moved to global scope
-    members = calloc(NUM_MEMBERS, sizeof(pthread_t));
-    member_args = calloc(NUM_MEMBERS, sizeof(thread_args_t));
-    int *agent_flags = calloc(NUM_MEMBERS, sizeof(int));
-    if (!members || !member_args)
+    g->members = calloc(g->num_members, sizeof(pthread_t));
+    g->member_args = calloc(g->num_members, sizeof(thread_args_t));
+    int *agent_flags = calloc(g->num_members, sizeof(int));
+    if (!g->members || !g->member_args)
     {
         perror("calloc");
         exit(EXIT_FAILURE);
     }
 
-    int agent_count = 1 + rand() % 2;
+    member_task_t *member_tasks = NULL;
+    leader_task_t leader_task = {0};
+    if (member_pool)
+    {
+        member_tasks = calloc(g->num_members, sizeof(*member_tasks));
+        if (!member_tasks)
+        {
+            perror("calloc");
+            exit(EXIT_FAILURE);
+        }
+        pthread_mutex_init(&g->tasks_mtx, NULL);
+        pthread_cond_init(&g->tasks_done, NULL);
+        g->tasks_running = g->num_members; // every member and the leader
+        LOG(LOG_INFO, "🧵 Gang[%d] runs %d members on %d worker(s)%s\n",
+                      gang_id, g->num_members, executor_workers(member_pool),
+                      shm->cfg.clock_mode == CLOCK_MODE_VIRTUAL ? " in virtual time" : "");
+        leader_task.task.fn = leader_step;
+        leader_task.task.arg = &leader_task;
+        leader_task.ta = &leader_args;
+        executor_spawn(member_pool, &leader_task.task);
+    }
+
+    int agent_count = 1 + rng_below(&g->rng, 2);
     for (int i = 0; i < agent_count;)
     {
         //__Talin SUN prevent leaders from becoming agents
-        int idx = rand() % NUM_MEMBERS;
+        int idx = rng_below(&g->rng, g->num_members);
         if (!agent_flags[idx] && idx != leader_id)
         {
             agent_flags[idx] = 1;
@@ -959,25 +1756,25 @@ int main(int argc, char *argv[])
         }
     }
 
-    for (int i = 0; i < NUM_MEMBERS; i++)
+    for (int i = 0; i < g->num_members; i++)
     {
         //__Talin FRI
         if (i == leader_id)
         {
-            member_args[i] = leader_args; // copy leader args
+            g->member_args[i] = leader_args; // copy leader args
             continue;                     // skip leader
         }
-        float info_accuracy = assign_info_accuracy(ranks[i]);
-        printf("\U0001F522 Member[%d] from Gang[%d] | Rank=%d → Probability of true info = %.2f%%\n",
-               i, gang_id, ranks[i], info_accuracy * 100);
+        float info_accuracy = assign_info_accuracy(g, ranks[i]);
+        LOG(LOG_INFO, "\U0001F522 Member[%d] from Gang[%d] | Rank=%d → Probability of true info = %.2f%%\n",
+                      i, gang_id, ranks[i], info_accuracy * 100);
 
         //__Talin tue
         // note this code must be added before each mission to ensure that sen probabilities changes based on credibility
-        double luck = (((double)rand() / RAND_MAX) - 0.5) * zeta;
+        double luck = (rng_unit(&g->rng) - 0.5) * zeta;
         double blended = alpha * (shm->cfg.send_prob) + (1 - alpha) * 0.5;
         // ← drop fmin/fmax and use CLAMP
         double send_prob = CLAMP(blended + luck, 0.0, 1.0);
-        member_args[i] = (thread_args_t){
+        g->member_args[i] = (thread_args_t){
             .id = i,
             .gang_id = gang_id,
             .rank = ranks[i],
@@ -990,35 +1787,46 @@ int main(int argc, char *argv[])
             .mission_duration_s = MISSION_DURATION_S,
             .barrier = &mission_barrier,
             .is_agent = agent_flags[i],
-            .pq = &pq,
+            .pq = g->pq,
+            .gang = g,
             .info_accuracy = info_accuracy,
             .credibility = info_accuracy, // ADDED MAYS everyone starts equal — credibility earned later
             .send_prob = send_prob,
             .prep_level = 0, // added mayar
             .is_ready = 0    // added mayar
         };
+        rng_seed(&g->member_args[i].rng, (uint64_t)shm->cfg.random_seed, gang_id, i);
 
-        member_args[i].peer_count = rank_count[ranks[i]] - 1;
-        member_args[i].peers = malloc(sizeof(int) * member_args[i].peer_count);
+        g->member_args[i].peer_count = rank_count[ranks[i]] - 1;
+        g->member_args[i].peers = malloc(sizeof(int) * g->member_args[i].peer_count);
 
         int idx = 0;
         for (int j = 0; j < rank_count[ranks[i]]; j++)
         {
             int peer = rank_members[ranks[i]][j];
             if (peer != i)
-                member_args[i].peers[idx++] = peer;
+                g->member_args[i].peers[idx++] = peer;
         }
-        member_args[i].peer_prob = shm->cfg.peer_prob; // e.g. 5% chance per tick
+        g->member_args[i].peer_prob = shm->cfg.peer_prob; // e.g. 5% chance per tick
 
         // added by hala :
         // ADDED HALA: initialize crime knowledge to 0
         for (int c = 0; c < NUM_MISSIONS; c++)
         {
-            member_args[i].crime_knowledge[c] = 0.0f;
+            g->member_args[i].crime_knowledge[c] = 0.0f;
+        }
+        if (member_pool)
+        {
+            member_tasks[i].task.fn = member_step;
+            member_tasks[i].task.arg = &member_tasks[i];
+            member_tasks[i].ta = &g->member_args[i];
+            executor_spawn(member_pool, &member_tasks[i].task);
+        }
+        else
+        {
+            pthread_create(&g->members[i], NULL, member_thread, &g->member_args[i]);
         }
-        pthread_create(&members[i], NULL, member_thread, &member_args[i]);
     }
-    pthread_barrier_wait(&mission_barrier + 1);
     // analyze_distribution_log(member_args, NUM_MEMBERS); /// added by mayar
 
     //     if (gang_was_caught) {  /// make it after arresting ///
@@ -1026,13 +1834,13 @@ int main(int argc, char *argv[])
     // }
     /////////////////////////  --- ADDED MAYS STARTS ----- ///////////////////////
 
-    for (int i = 0; i < NUM_MEMBERS; i++)
+    for (int i = 0; i < g->num_members; i++)
     {
 
-        double base_cred = member_args[i].credibility;
+        double base_cred = g->member_args[i].credibility;
 
         // 1) random_pct ∈ [0, 0.025]
-        double random_pct = ((double)rand() / (double)RAND_MAX) * 0.025;
+        double random_pct = rng_unit(&g->rng) * 0.025;
 
         // 2) luck = base_cred × random_pct
         double luck = base_cred * random_pct;
@@ -1041,45 +1849,58 @@ int main(int argc, char *argv[])
         double effective_cred = base_cred + luck;
 
         // promotion/demotion on effective_cred
-        if (effective_cred > 0.75 && member_args[i].rank < leader_rank)
+        if (effective_cred > 0.75 && g->member_args[i].rank < leader_rank)
         {
-            member_args[i].rank++;
-            printf("🔼 Member[%d] promoted to Rank %d (Cred: %.2f + Luck: %.3f → Eff: %.2f)\n",
-                   i,
-                   member_args[i].rank,
-                   base_cred,
-                   luck,
-                   effective_cred);
+            g->member_args[i].rank++;
+            LOG(LOG_INFO, "🔼 Member[%d] promoted to Rank %d (Cred: %.2f + Luck: %.3f → Eff: %.2f)\n",
+                          i,
+                          g->member_args[i].rank,
+                          base_cred,
+                          luck,
+                          effective_cred);
         }
-        else if (effective_cred < 0.20 && member_args[i].rank > 0)
+        else if (effective_cred < 0.20 && g->member_args[i].rank > 0)
         {
-            member_args[i].rank--;
-            printf("🔽 Member[%d] demoted to Rank %d (Cred: %.2f + Luck: %.3f → Eff: %.2f)\n",
-                   i,
-                   member_args[i].rank,
-                   base_cred,
-                   luck,
-                   effective_cred);
+            g->member_args[i].rank--;
+            LOG(LOG_INFO, "🔽 Member[%d] demoted to Rank %d (Cred: %.2f + Luck: %.3f → Eff: %.2f)\n",
+                          i,
+                          g->member_args[i].rank,
+                          base_cred,
+                          luck,
+                          effective_cred);
         }
     }
-    for (int i = 0; i < NUM_MEMBERS; i++)
+    for (int i = 0; i < g->num_members; i++)
     {
-        printf("📊 Member[%d] Final Rank: %d | Base Cred: %.2f\n",
-               member_args[i].id,
-               member_args[i].rank,
-               member_args[i].credibility);
+        LOG(LOG_INFO, "📊 Member[%d] Final Rank: %d | Base Cred: %.2f\n",
+                      g->member_args[i].id,
+                      g->member_args[i].rank,
+                      g->member_args[i].credibility);
     }
     /////////////////////////  --- ADDED MAYS ENDS ----- ///////////////////////
-    pthread_join(leader, NULL);
-    for (int i = 0; i < NUM_MEMBERS; i++)
-        pthread_join(members[i], NULL);
+    if (member_pool)
+    {
+        executor_release(member_pool); // this gang is set up; main() held the clock for it
+        pthread_mutex_lock(&g->tasks_mtx);
+        while (g->tasks_running > 0)
+            pthread_cond_wait(&g->tasks_done, &g->tasks_mtx);
+        pthread_mutex_unlock(&g->tasks_mtx);
+        free(member_tasks);
+    }
+    else
+    {
+        pthread_join(leader, NULL);
+        for (int i = 0; i < g->num_members; i++)
+            if (i != leader_id)
+                pthread_join(g->members[i], NULL);
+    }
     // hala start add *********************************************************************************************************************
     // HIRE NEW MEMBERS LOGIC STARTS HERE (STEP 5)
 
     int dead_members = 0;
-    for (int i = 0; i < NUM_MEMBERS; i++)
+    for (int i = 0; i < g->num_members; i++)
     {
-        if (member_args[i].is_dead)
+        if (g->member_args[i].is_dead)
         {
             dead_members++;
         }
@@ -1087,41 +1908,53 @@ int main(int argc, char *argv[])
     if (leader_args.is_dead)
         dead_members++;
 
-    printf("💀 Total dead members this mission: %d\n", dead_members);
+    LOG(LOG_INFO, "💀 Total dead members this mission: %d\n", dead_members);
+
+    uint32_t lost = 0, deepest = 0;
+    for (int i = 0; i < g->num_members; i++)
+    {
+        lost += atomic_load(g->queues[i].overflow);
+        if (atomic_load(g->queues[i].hwm) > deepest)
+            deepest = atomic_load(g->queues[i].hwm);
+    }
+    LOG(LOG_INFO, "📦 Gang[%d] queues: %u overflow(s), high-watermark %u/%zu\n",
+                  gang_id, lost, deepest, g->queues[0].mask + 1);
 
-    int current_alive = NUM_MEMBERS - dead_members;
+    int current_alive = g->num_members - dead_members;
     int hire_needed = shm->cfg.gang_members_min - current_alive;
 
     if (hire_needed <= 0)
     {
-        printf("No new members needed.\n");
+        LOG(LOG_INFO, "No new members needed.\n");
     }
     else
     {
-        printf("🧑‍💼 Need to hire %d new member(s) to meet minimum threshold.\n", hire_needed);
+        LOG(LOG_INFO, "🧑‍💼 Need to hire %d new member(s) to meet minimum threshold.\n", hire_needed);
         if (hire_needed > 0)
         {
             for (int h = 0; h < hire_needed; h++)
             {
-                int new_id = NUM_MEMBERS + h;
-                int new_rank = rand() % shm->cfg.ranking_levels;
-                printf("🆕 Hiring new member [%d] with Rank %d\n", new_id, new_rank);
+                int new_id = g->num_members + h;
+                int new_rank = rng_below(&g->rng, shm->cfg.ranking_levels);
+                LOG(LOG_INFO, "🆕 Hiring new member [%d] with Rank %d\n", new_id, new_rank);
             }
         }
     }
 
     // === STEP 3: REBUILD MANAGERS ===
-    int new_total_members = NUM_MEMBERS + hire_needed;
+    if (hire_needed < 0)
+        hire_needed = 0; // above the minimum: nobody to hire
+    int new_total_members = g->num_members + hire_needed;
     int *new_ranks = malloc(new_total_members * sizeof(int));
     int *new_manager = malloc(new_total_members * sizeof(int));
 
     // copy alive ranks
     int alive_index = 0;
-    for (int i = 0; i < NUM_MEMBERS; i++)
+    for (int i = 0; i < g->num_members; i++)
     {
-        if (!member_args[i].is_dead)
+        if (!g->member_args[i].is_dead)
         {
-            new_ranks[alive_index] = member_args[i].rank;
+            new_ranks[alive_index] = g->member_args[i].rank;
             alive_index++;
         }
     }
@@ -1129,7 +1962,7 @@ int main(int argc, char *argv[])
     // add new hires
     for (int h = 0; h < hire_needed; h++)
     {
-        int new_rank = rand() % shm->cfg.ranking_levels;
+        int new_rank = rng_below(&g->rng, shm->cfg.ranking_levels);
         new_ranks[alive_index] = new_rank;
         alive_index++;
     }
@@ -1161,47 +1994,188 @@ int main(int argc, char *argv[])
     for (int i = 0; i < new_total_members; i++)
     {
         if (new_manager[i] == -1)
-            printf("👑 Member[%d] (Rank=%d) is Leader\n", i, new_ranks[i]);
+            LOG(LOG_INFO, "👑 Member[%d] (Rank=%d) is Leader\n", i, new_ranks[i]);
         else
-            printf("🧑‍🤝‍🧑 Member[%d] (Rank=%d) → Manager = Member[%d] (Rank=%d)\n",
-                   i, new_ranks[i], new_manager[i], new_ranks[new_manager[i]]);
+            LOG(LOG_INFO, "🧑‍🤝‍🧑 Member[%d] (Rank=%d) → Manager = Member[%d] (Rank=%d)\n",
+                          i, new_ranks[i], new_manager[i], new_ranks[new_manager[i]]);
     }
 
     // === STEP 4: APPLY PROMOTION/DEMOTION ===
 
     for (int i = 0; i < new_total_members; i++)
     {
-        double base_cred = 0.5 + ((rand() % 50) / 100.0);
-        double random_pct = ((double)rand() / (double)RAND_MAX) * 0.025;
+        double base_cred = 0.5 + (rng_below(&g->rng, 50) / 100.0);
+        double random_pct = rng_unit(&g->rng) * 0.025;
         double luck = base_cred * random_pct;
         double effective_cred = base_cred + luck;
 
         if (effective_cred > 0.75 && new_ranks[i] < shm->cfg.ranking_levels)
         {
             new_ranks[i]++;
-            printf("🔼 Member[%d] promoted to Rank %d (Cred: %.2f + Luck: %.3f → Eff: %.2f)\n",
-                   i, new_ranks[i], base_cred, luck, effective_cred);
+            LOG(LOG_INFO, "🔼 Member[%d] promoted to Rank %d (Cred: %.2f + Luck: %.3f → Eff: %.2f)\n",
+                          i, new_ranks[i], base_cred, luck, effective_cred);
         }
         else if (effective_cred < 0.20 && new_ranks[i] > 0)
         {
             new_ranks[i]--;
-            printf("🔽 Member[%d] demoted to Rank %d (Cred: %.2f + Luck: %.3f → Eff: %.2f)\n",
-                   i, new_ranks[i], base_cred, luck, effective_cred);
+            LOG(LOG_INFO, "🔽 Member[%d] demoted to Rank %d (Cred: %.2f + Luck: %.3f → Eff: %.2f)\n",
+                          i, new_ranks[i], base_cred, luck, effective_cred);
         }
     }
 
     // hala end add********************************************************************************************************
     //__Talin fri
-    free(members);
-    free(member_args);
+    report_batcher_stop(g);
+    for (int i = 0; i < g->num_members; i++)
+        if (i != leader_id)
+            free(g->member_args[i].backlog);
+    free(leader_args.backlog);
+    free(g->members);
+    free(g->member_args);
+    for (int ii = 0; ii < MAX_INTEL_CODES; ii++)
+    {
+        intel_graph_t *gr = g->graph[ii];
+        if (!gr)
+            continue;
+        free(gr->out);
+        free(gr->parent);
+        free(gr);
+        g->graph[ii] = NULL;
+    }
+    free(g->suspicion_count);
+    free(g->suspect_intel);
+    free(g->graph_stack);
+    pthread_mutex_destroy(&g->graph_mtx);
+    arena_destroy(&g->history_arena);
 
-    pthread_barrier_destroy(&mission_barrier);
-    pq_close(&pq);
+    task_barrier_destroy(&mission_barrier);
     free(agent_flags);
     free(ranks);
     free(new_ranks);   //***************************************************************************************
     free(new_manager); //*******************************************************************************
 
-    printf("\u2705 [GangProcess] Exiting cleanly.\n");
+    return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    printf("\U0001F3AC [GangProcess] Starting up...\n");
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "\u274C Usage: %s <gang_id> [<gang_id>...]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+
+    num_hosted = argc - 1;
+    gangs = calloc(num_hosted, sizeof(*gangs));
+    if (!gangs)
+    {
+        perror("calloc");
+        exit(EXIT_FAILURE);
+    }
+    for (int k = 0; k < num_hosted; k++)
+    {
+        gangs[k].gang_id = atoi(argv[k + 1]);
+        printf("\U0001F522 Parsed gang_id = %d\n", gangs[k].gang_id);
+    }
+    fflush(stdout);
+
+    shm = shm_child_attach();
+    if (!shm)
+    {
+        perror("\u274C shm_child_attach");
+        exit(EXIT_FAILURE);
+    }
+    // before the first thread (the log flusher), so every thread inherits it
+    static sigset_t term;
+    sigemptyset(&term);
+    sigaddset(&term, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &term, NULL);
+    log_init(shm->cfg.logging_verbosity);
+    pthread_t term_thr;
+    if (pthread_create(&term_thr, NULL, term_thread, &term) != 0)
+    {
+        perror("pthread_create term");
+        exit(EXIT_FAILURE);
+    }
+
+    // register signal handler for SIGUSR1
+    struct sigaction sa;
+    sa.sa_sigaction = handle_sigusr1;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART | SA_SIGINFO; // restart syscalls; need si_value for the gang id
+    if (sigaction(SIGUSR1, &sa, NULL) < 0)
+    {
+        perror("sigaction(SIGUSR1)");
+        exit(EXIT_FAILURE);
+    }
+    struct sigaction sa2;
+    sa2.sa_handler = handle_sigusr2;
+    sigemptyset(&sa2.sa_mask);
+    sa2.sa_flags = SA_RESTART; // so interrupted syscalls auto-restart
+    if (sigaction(SIGUSR2, &sa2, NULL) < 0)
+    {
+        perror("sigaction(SIGUSR2)");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int k = 0; k < num_hosted; k++)
+    {
+        char name[64];
+        police_ingest_name(name, sizeof name, gangs[k].gang_id);
+        if (pq_open(&gangs[k].ingest, name) == -1)
+        {
+            perror("\u274C pq_open");
+            exit(EXIT_FAILURE);
+        }
+        gangs[k].pq = &gangs[k].ingest;
+        LOG(LOG_INFO, "\U0001F4E2 Opened police queue:%s (mq=%d, msg_size=%zu)\n",
+                      gangs[k].pq->name, (int)gangs[k].pq->mq, gangs[k].pq->msg_size);
+    }
+    fflush(stdout);
+    if (shm->cfg.event_log_records > 0 && evlog_open(&event_log, EVLOG_PATH, 1) == -1)
+        perror("\u26A0\uFE0F evlog_open " EVLOG_PATH " (transmissions not logged)");
+
+    // executor_workers: 0 = one pthread per member, N = N workers, -1 = one per core.
+    // Virtual time needs the pool; it defaults to one worker, which also
+    // makes a seeded run replay exactly.
+    int virtual_time = shm->cfg.clock_mode == CLOCK_MODE_VIRTUAL;
+    if (shm->cfg.executor_workers != 0 || virtual_time)
+    {
+        member_pool = executor_create(shm->cfg.executor_workers != 0 ? shm->cfg.executor_workers : 1,
+                                      virtual_time, &shm->clock);
+        if (!member_pool)
+        {
+            perror("executor_create");
+            exit(EXIT_FAILURE);
+        }
+        // no virtual time passes until every hosted gang has spawned its tasks
+        for (int k = 0; k < num_hosted; k++)
+            executor_hold(member_pool);
+    }
+
+    for (int k = 0; k < num_hosted; k++)
+    {
+        if (pthread_create(&gangs[k].thread, NULL, gang_main, &gangs[k]) != 0)
+        {
+            perror("pthread_create gang");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int k = 0; k < num_hosted; k++)
+        pthread_join(gangs[k].thread, NULL);
+
+    if (member_pool)
+    {
+        executor_wait(member_pool);
+        executor_destroy(member_pool);
+        member_pool = NULL;
+    }
+    for (int k = 0; k < num_hosted; k++)
+        pq_close(&gangs[k].ingest);
+
+    LOG(LOG_INFO, "\u2705 [GangProcess] Exiting cleanly.\n");
     return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -125,23 +125,19 @@ static void display() {
 
     drawFrame(&prisonSheet, 0, pad, pad + 20);
 
-    pthread_rwlock_rdlock(&shm->rwlock);
-    int thwarted = shm->score.plans_thwarted;
-    int successful = shm->score.plans_success;
-    int arrests = shm->police.arrests_made;
-    int num_gangs = shm->cfg.num_gangs;
-    
-
-    // 👇 Capture suspicion per gang before unlocking
-    double suspicion_vals[MAX_GANGS];
+    int thwarted = score_get_plans_thwarted(shm);
+    int successful = score_get_plans_success(shm);
+    int arrests = police_get_arrests(shm);
+    int num_gangs = shm->cfg.num_gangs;   // cfg is fixed before the GUI starts
+
+    // 👇 One torn-free snapshot per gang for the whole frame; the gang
+    //    processes keep writing while we draw
+    static gang_snapshot_t snaps[MAX_GANGS];
     for (int g = 0; g < num_gangs; g++) {
-        suspicion_vals[g] = shm->suspicion[g];
+        gang_snapshot(shm, g, &snaps[g], shm->cfg.gang_members_max);
     }
-    pthread_rwlock_unlock(&shm->rwlock);
 
-    pthread_rwlock_rdlock(&shm->rwlock);
-int tips = shm->police.tips_waiting;
-pthread_rwlock_unlock(&shm->rwlock);
+int tips = police_get_tips(shm);
 
 // reserve position for police info display
 int y = H - pad - ps0->fh - 60;
@@ -183,7 +179,7 @@ drawText(pad + 5, y, line); y -= 20;
 
 for (int g = 0; g < num_gangs; g++) {
     char suspicionLine[64];
-    snprintf(suspicionLine, sizeof(suspicionLine), "Suspicion[Gang %d]: %.2f", g + 1, suspicion_vals[g]);
+    snprintf(suspicionLine, sizeof(suspicionLine), "Suspicion[Gang %d]: %.2f", g + 1, snaps[g].suspicion);
     drawText(pad + 5, y, suspicionLine);
     y -= 20;
 }
@@ -191,13 +187,10 @@ for (int g = 0; g < num_gangs; g++) {
 
     glColor3f(1,1,1); glBegin(GL_LINES); glVertex2f(policePanel,0); glVertex2f(policePanel,H); glEnd();
 
-    pthread_rwlock_rdlock(&shm->rwlock);
-
-
     // Auto layout decision
     bool useGridLayout = false;
     for (int g = 0; g < num_gangs; g++) {
-        if (shm->gang[g].members_alive > 9) {
+        if (snaps[g].members_alive > 9) {
             useGridLayout = true;
             break;
         }
@@ -211,7 +204,7 @@ for (int g = 0; g < num_gangs; g++) {
         
     for (int g = 0; g < num_gangs; g++) {
 
-    if (shm->gang[g].jailed) {
+    if (snaps[g].jailed) {
     char label[64];
     snprintf(label, sizeof(label), "Gang %d in prison", g + 1);
     drawText(startX + 10, y_cursor - 30, label);
@@ -231,7 +224,7 @@ for (int g = 0; g < num_gangs; g++) {
 
     for (int i = 0; i < shm->cfg.gang_members_max; i++) {
         // Skip dead members
-        if (shm->gang_member_dead[g][i]) continue;
+        if (snaps[g].member_dead[i]) continue;
 
         int col = count % cols;
         int row = count / cols;
@@ -242,7 +235,7 @@ for (int g = 0; g < num_gangs; g++) {
         drawFrameScaled(sh, 0, x, y, 0.45f);
 
         char rankBuf[32];
-        snprintf(rankBuf, sizeof(rankBuf), "Rank: %d", shm->gang_ranks[g][i]);
+        snprintf(rankBuf, sizeof(rankBuf), "Rank: %d", snaps[g].ranks[i]);
         drawText(x, y - 20, rankBuf);
 
         count++;
@@ -255,7 +248,7 @@ for (int g = 0; g < num_gangs; g++) {
 
 
 
-            int alive = shm->gang[g].members_alive;
+            int alive = snaps[g].members_alive;
             int cols = (alive < 5) ? alive : 5;
             if (cols <= 0) cols = 1;
 
@@ -283,7 +276,7 @@ snprintf(title, sizeof(title), "Gang %d  %s", g + 1, shm->cfg.crimes[g % shm->cf
 drawText(startX + 10, titleY, title);
 
 // If jailed, draw ARRESTED in red next to it
-if (shm->gang[g].jailed) {
+if (snaps[g].jailed) {
     glColor3f(1.0f, 0.0f, 0.0f);  // red
     drawText(startX + 300, titleY, "ARRESTED");
     glColor3f(1, 1, 1);  // reset to white
@@ -301,7 +294,7 @@ if (shm->gang[g].jailed) {
                 int y = memberStartY - row * spacingY;
                 
                 /////  Change gang member to “run” during prep and back to idle or “READY” //////// to run while preparing ///
-                int prep = shm->gang_prep_levels[g][i];
+                int prep = snaps[g].prep_levels[i];
     int is_ready = (prep >= shm->cfg.required_prep_level);
     int state = STATE_IDLE;
 
@@ -319,7 +312,7 @@ if (shm->gang[g].jailed) {
     //     state = STATE_WALK; // Show run
     // }
     // If the member is killed
-    // else if (shm->gang[g].killed[i]) {  // <- Add this to shm_layout_t
+    // else if (shm->per_gang[g].state.killed[i]) {  // <- Add this to shm_layout_t
     //     state = STATE_DEAD;
     // }
 
@@ -327,7 +320,7 @@ if (shm->gang[g].jailed) {
 
     drawFrameScaled(sh, state == STATE_WALK ? gangFrame : 0, x, y, scale);
 
-                int rank = shm->gang_ranks[g][i];
+                int rank = snaps[g].ranks[i];
                 
 
                 char rankBuf[32], prepBuf[32];
@@ -365,7 +358,7 @@ if (shm->gang[g].jailed) {
             int ox = startX + gx * cellW;
             int oy = H - gy * cellH - pad;
 
-            int alive = shm->gang[g].members_alive;
+            int alive = snaps[g].members_alive;
             int mcols = (alive <= 5) ? alive : 5;
             if (mcols <= 0) mcols = 1;
 
@@ -387,14 +380,14 @@ if (shm->gang[g].jailed) {
                 int y = oy - 60 - row * spacingY;
 
                 //Sheet *sh = &gangSheets[STATE_IDLE][i % CHAR_PER_G];
-                int rank = shm->gang_ranks[g][i];
-                //int prep = shm->gang_prep_levels[g][i];
+                int rank = snaps[g].ranks[i];
+                //int prep = shm->per_gang[g].prep_levels[i];
 
-                int prep = shm->gang_prep_levels[g][i];
+                int prep = snaps[g].prep_levels[i];
                 int is_ready = (prep >= shm->cfg.required_prep_level);
                 int state = STATE_IDLE;
-                if (shm->gang[g].jailed == 0) {
-                    if (shm->gang_member_dead[g][i]) {
+                if (snaps[g].jailed == 0) {
+                    if (snaps[g].member_dead[i]) {
                         state = STATE_DEAD;
                     } else if (!is_ready && prep > 0) {
                         state = STATE_WALK;
@@ -415,7 +408,6 @@ if (shm->gang[g].jailed) {
         }
     }
 
-    pthread_rwlock_unlock(&shm->rwlock);
     glutSwapBuffers();
 }
 
@@ -4,7 +4,11 @@
 #include <errno.h>
 #include <time.h>
 #include <mqueue.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 #include "ipc_utils.h"  // police_queue_t, police_report_t
+#include "log.h"
 
 // Helper: make absolute timeout (unused here but kept for completeness)
 static void make_abs_timeout(struct timespec *ts, int ms) {
@@ -17,13 +21,222 @@ static void make_abs_timeout(struct timespec *ts, int ms) {
     }
 }
 
+// ───────────── Shared-memory ring transport ─────────────
+// The same Vyukov sequence-slot ring as msg_queue_t, laid out in its own
+// shm segment ("<queue name>_ring") so producers in one process can
+// feed a consumer in another: each gang's ingest queue is written by
+// that gang's agents and read by its one police listener. A send is a
+// single copy into the mapped slot (none through the kernel) and has no
+// msg_max/msgsize_max limits.
+// Consumers that find it empty sleep on a process-shared futex that
+// producers bump after each publish.
+#define RING_MAGIC 0x52494e47u   // "RING", written last by pq_create
+
+typedef struct {
+    _Atomic uint64_t seq;
+    uint32_t         len;
+    uint32_t         pad;
+    unsigned char    data[];
+} ring_slot_t;
+
+struct shm_ring {
+    _Atomic uint32_t magic;
+    uint32_t         msg_size;   // largest payload per slot
+    uint32_t         stride;     // bytes per slot, cache-line multiple
+    uint32_t         pad;
+    uint64_t         mask;       // capacity - 1; capacity is a power of two
+    _Alignas(64) _Atomic uint64_t head;     // next ticket to consume
+    _Alignas(64) _Atomic uint64_t tail;     // next ticket to produce
+    _Alignas(64) _Atomic uint32_t posted;   // futex word, bumped per publish
+    _Atomic uint32_t waiters;               // consumers asleep on posted
+    _Alignas(64) unsigned char slots[];
+};
+
+static void ring_shm_name(char *out, size_t n, const char *name) {
+    snprintf(out, n, "%s_ring", name);
+}
+
+static ring_slot_t *ring_slot(struct shm_ring *r, uint64_t pos) {
+    return (ring_slot_t *)(r->slots + (pos & r->mask) * r->stride);
+}
+
+static long futex(_Atomic uint32_t *addr, int op, uint32_t val, const struct timespec *ts) {
+    return syscall(SYS_futex, (uint32_t *)addr, op, val, ts, NULL, 0);
+}
+
+static int ring_create(const char *name, size_t msg_size, long depth) {
+    char path[128];
+    ring_shm_name(path, sizeof path, name);
+    uint64_t cap = 1;
+    while (cap < (uint64_t)(depth > 0 ? depth : 1)) cap <<= 1;
+    size_t stride = (sizeof(ring_slot_t) + msg_size + SHM_CACHELINE - 1) & ~(size_t)(SHM_CACHELINE - 1);
+    size_t bytes = sizeof(struct shm_ring) + cap * stride;
+
+    shm_unlink(path);
+    int fd = shm_open(path, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd == -1) return -1;
+    if (ftruncate(fd, bytes) == -1) {
+        close(fd);
+        shm_unlink(path);
+        return -1;
+    }
+    struct shm_ring *r = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (r == MAP_FAILED) {
+        shm_unlink(path);
+        return -1;
+    }
+    r->msg_size = msg_size;
+    r->stride = stride;
+    r->mask = cap - 1;
+    atomic_init(&r->head, 0);
+    atomic_init(&r->tail, 0);
+    atomic_init(&r->posted, 0);
+    atomic_init(&r->waiters, 0);
+    for (uint64_t i = 0; i < cap; ++i)
+        atomic_init(&ring_slot(r, i)->seq, i);
+    atomic_store_explicit(&r->magic, RING_MAGIC, memory_order_release);
+    munmap(r, bytes);
+    return 0;
+}
+
+// 1 = attached to an existing ring, 0 = no ring by that name, -1 = error
+static int ring_attach(police_queue_t *pq, const char *name) {
+    char path[128];
+    struct stat st;
+    ring_shm_name(path, sizeof path, name);
+    int fd = shm_open(path, O_RDWR, 0600);
+    if (fd == -1) return errno == ENOENT ? 0 : -1;
+    if (fstat(fd, &st) == -1 || (size_t)st.st_size < sizeof(struct shm_ring)) {
+        close(fd);
+        return -1;
+    }
+    struct shm_ring *r = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (r == MAP_FAILED) return -1;
+    if (atomic_load_explicit(&r->magic, memory_order_acquire) != RING_MAGIC) {
+        munmap(r, st.st_size);
+        errno = EPROTO;
+        return -1;
+    }
+    pq->mq         = (mqd_t)-1;
+    pq->ring       = r;
+    pq->ring_bytes = st.st_size;
+    pq->msg_size   = r->msg_size;
+    strncpy(pq->name, name, sizeof(pq->name)-1);
+    pq->name[sizeof(pq->name)-1] = '\0';
+    return 1;
+}
+
+// returns 0, or -1 with EAGAIN when the ring is full (like O_NONBLOCK mq_send)
+static int ring_send(struct shm_ring *r, const void *msg, size_t len) {
+    if (len > r->msg_size) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+    uint64_t pos = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    ring_slot_t *slot;
+    for (;;) {
+        slot = ring_slot(r, pos);
+        uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        int64_t diff = (int64_t)(seq - pos);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&r->tail, &pos, pos + 1,
+                    memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            errno = EAGAIN;
+            return -1;
+        } else {
+            pos = atomic_load_explicit(&r->tail, memory_order_relaxed);
+        }
+    }
+    memcpy(slot->data, msg, len);
+    slot->len = len;
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+    // seq_cst pairs with the consumer's waiters++/re-check in ring_recv
+    atomic_fetch_add(&r->posted, 1);
+    if (atomic_load(&r->waiters) > 0)
+        futex(&r->posted, FUTEX_WAKE, 1, NULL);
+    return 0;
+}
+
+static ssize_t ring_try_recv(struct shm_ring *r, void *out, size_t cap) {
+    uint64_t pos = atomic_load_explicit(&r->head, memory_order_relaxed);
+    ring_slot_t *slot;
+    for (;;) {
+        slot = ring_slot(r, pos);
+        uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        int64_t diff = (int64_t)(seq - (pos + 1));
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&r->head, &pos, pos + 1,
+                    memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            return 0;
+        } else {
+            pos = atomic_load_explicit(&r->head, memory_order_relaxed);
+        }
+    }
+    size_t len = slot->len;
+    memcpy(out, slot->data, len < cap ? len : cap);
+    atomic_store_explicit(&slot->seq, pos + r->mask + 1, memory_order_release);
+    if (len > cap) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+    return (ssize_t)len;
+}
+
+// Blocks like mq_receive. The futex sleep is bounded so that a cancelled
+// thread (the referee is stopped with pthread_cancel) notices promptly.
+static ssize_t ring_recv(struct shm_ring *r, void *out, size_t cap) {
+    const struct timespec nap = { .tv_sec = 0, .tv_nsec = 200 * 1000000L };
+    for (;;) {
+        ssize_t n = ring_try_recv(r, out, cap);
+        if (n != 0) return n;
+        uint32_t seen = atomic_load(&r->posted);
+        atomic_fetch_add(&r->waiters, 1);
+        n = ring_try_recv(r, out, cap);
+        if (n == 0)
+            futex(&r->posted, FUTEX_WAIT, seen, &nap);
+        atomic_fetch_sub(&r->waiters, 1);
+        if (n != 0) return n;
+        pthread_testcancel();
+    }
+}
+
+// ─── Create / remove a queue (HQ) ─────────────────────────
+int pq_create(const char *name, size_t msg_size, long depth, int transport) {
+    pq_unlink(name); // force removal of anything stale, of either kind
+    if (transport == TRANSPORT_SHM_RING)
+        return ring_create(name, msg_size, depth);
+
+    struct mq_attr attr = {
+        .mq_flags = 0,
+        .mq_maxmsg = depth,
+        .mq_msgsize = msg_size,
+        .mq_curmsgs = 0};
+    mqd_t mq = mq_open(name, O_CREAT | O_RDWR, 0600, &attr);
+    if (mq == (mqd_t)-1) return -1;
+    mq_close(mq); // children will reopen in send or recv mode
+    return 0;
+}
+
+void pq_unlink(const char *name) {
+    char path[128];
+    ring_shm_name(path, sizeof path, name);
+    mq_unlink(name);
+    shm_unlink(path);
+}
+
 // ─── Open queue for *sending* (gang) ───────────────────────
 int pq_open(police_queue_t *pq, const char *name) {
     struct mq_attr attr;
+    int rc = ring_attach(pq, name);
+    if (rc != 0) return rc > 0 ? 0 : -1;
     // (Re)create queue if not already; you may call mq_unlink() in HQ before creating.
     mqd_t m = mq_open(name, O_CREAT | O_WRONLY | O_NONBLOCK, 0600, NULL);
-    printf("[DEBUG pq_open] name=%s → mqd=%d\n", name, (int)m);
-
     if (m == (mqd_t)-1) return -1;
     // fetch its attributes
     if (mq_getattr(m, &attr) == -1) {
@@ -32,6 +245,7 @@ int pq_open(police_queue_t *pq, const char *name) {
     }
     pq->mq       = m;
     pq->msg_size = attr.mq_msgsize;
+    pq->ring     = NULL;
     strncpy(pq->name, name, sizeof(pq->name)-1);
     pq->name[sizeof(pq->name)-1] = '\0';
     return 0;
@@ -40,6 +254,8 @@ int pq_open(police_queue_t *pq, const char *name) {
 // ─── Open queue for *receiving* (police) ──────────────────
 int pq_open_read(police_queue_t *pq, const char *name) {
     struct mq_attr attr;
+    int rc = ring_attach(pq, name);
+    if (rc != 0) return rc > 0 ? 0 : -1;
     mqd_t m = mq_open(name, O_RDONLY);
     if (m == (mqd_t)-1) return -1;
     if (mq_getattr(m, &attr) == -1) {
@@ -48,44 +264,119 @@ int pq_open_read(police_queue_t *pq, const char *name) {
     }
     pq->mq       = m;
     pq->msg_size = attr.mq_msgsize;
+    pq->ring     = NULL;
     strncpy(pq->name, name, sizeof(pq->name)-1);
     pq->name[sizeof(pq->name)-1] = '\0';
     return 0;
 }
 
-// ─── Send a report ────────────────────────────────────────
-int pq_send(police_queue_t *pq, const police_report_t *r) {
-    int ret = mq_send(pq->mq, (const char*)r, sizeof(*r), 0);
+// transport-independent send/receive of one message
+static int pq_send_raw(police_queue_t *pq, const void *msg, size_t len) {
+    if (pq->ring)
+        return ring_send(pq->ring, msg, len);
+    return mq_send(pq->mq, (const char*)msg, len, 0);
+}
+
+static ssize_t pq_recv_raw(police_queue_t *pq, void *out, size_t cap) {
+    if (pq->ring)
+        return ring_recv(pq->ring, out, cap);
+    return mq_receive(pq->mq, (char*)out, cap, NULL);
+}
+
+// ─── Send a batch of reports as one message ───────────────
+int pq_send_batch(police_queue_t *pq, const police_batch_t *b) {
+    if (b->count == 0 || b->count > MAX_REPORT_BATCH) {
+        errno = EINVAL;
+        return -1;
+    }
+    int ret = pq_send_raw(pq, b, POLICE_BATCH_BYTES(b->count));
     if (ret == -1) {
         int e = errno;
-        printf("[DEBUG pq_send] '%s' failed: errno=%d (%s)\n",
-               pq->name, e, strerror(e));
+        LOG(LOG_DEBUG, "[pq_send] '%s' failed: errno=%d (%s)\n",
+                       pq->name, e, strerror(e));
+        errno = e;
     }
     return ret;
 }
 
-// ─── Receive a report ─────────────────────────────────────
-int pq_recv(police_queue_t *pq, police_report_t *out) {
-    if (!pq || pq->mq == (mqd_t)-1) {
-        printf("[DEBUG pq_recv] invalid mq descriptor for '%s'\n", pq?pq->name:"(null)");
+// ─── Send a single report ─────────────────────────────────
+int pq_send(police_queue_t *pq, const police_report_t *r) {
+    police_batch_t b = { .count = 1 };
+    b.reports[0] = *r;
+    return pq_send_batch(pq, &b);
+}
+
+// ─── Receive one batch ────────────────────────────────────
+// Returns the number of reports in *out, or -1 (errno set).
+int pq_recv_batch(police_queue_t *pq, police_batch_t *out) {
+    if (!pq || (!pq->ring && pq->mq == (mqd_t)-1)) {
+        LOG(LOG_WARN, "[pq_recv] invalid mq descriptor for '%s'\n", pq?pq->name:"(null)");
+        errno = EBADF;
         return -1;
     }
-    unsigned int prio;
-    printf("[DEBUG pq_recv] calling mq_receive on '%s' (mq=%d, buf=%zu)\n",
-           pq->name, (int)pq->mq, pq->msg_size);
-    ssize_t bytes = mq_receive(pq->mq, (char*)out, pq->msg_size, &prio);
+    ssize_t bytes = pq_recv_raw(pq, out, sizeof(*out));
     if (bytes < 0) {
         int e = errno;
-        printf("[DEBUG pq_recv] mq_receive failed on '%s': errno=%d (%s)\n",
-               pq->name, e, strerror(e));
+        LOG(LOG_WARN, "[pq_recv] receive failed on '%s': errno=%d (%s)\n",
+                      pq->name, e, strerror(e));
+        errno = e;
         return -1;
     }
-    printf("[DEBUG pq_recv] received %zd bytes prio=%u\n", bytes, prio);
-    return (int)bytes;
+    if ((size_t)bytes < POLICE_BATCH_BYTES(0) || out->count > MAX_REPORT_BATCH ||
+        (size_t)bytes != POLICE_BATCH_BYTES(out->count)) {
+        LOG(LOG_WARN, "[pq_recv] malformed frame on '%s' (%zd bytes)\n", pq->name, bytes);
+        errno = EBADMSG;
+        return -1;
+    }
+    return out->count;
+}
+
+// ─── Control channel ──────────────────────────────────────
+int ctrl_send(police_queue_t *pq, const police_report_t *order, const _Atomic int *run_over) {
+    const struct timespec backoff = { .tv_sec = 0, .tv_nsec = 1000000L };
+    unsigned prio = order->action == ARREST_ALL ? CTRL_PRIO_ARREST : CTRL_PRIO_THWART;
+    int tries = 0;
+    while (mq_send(pq->mq, (const char*)order, sizeof(*order), prio) == -1) {
+        if (errno != EAGAIN && errno != EINTR) {
+            int e = errno;
+            LOG(LOG_WARN, "[ctrl_send] '%s' failed: errno=%d (%s)\n",
+                          pq->name, e, strerror(e));
+            errno = e;
+            return -1;
+        }
+        if (atomic_load(run_over)) {
+            errno = ESHUTDOWN;
+            return -1;
+        }
+        if (++tries == CTRL_SEND_RETRIES) {
+            errno = ETIMEDOUT;
+            return -1;
+        }
+        nanosleep(&backoff, NULL);
+    }
+    return 0;
+}
+
+// 0 on success, -1 (errno set) on error or a malformed message
+int ctrl_recv(police_queue_t *pq, police_report_t *out) {
+    char buf[sizeof(police_batch_t)]; // ≥ any mq_msgsize we create
+    ssize_t bytes = mq_receive(pq->mq, buf, sizeof buf, NULL);
+    if (bytes < 0) return -1;
+    if ((size_t)bytes != sizeof(*out)) {
+        errno = EBADMSG;
+        return -1;
+    }
+    memcpy(out, buf, sizeof(*out));
+    return 0;
 }
 
 // ─── Close the queue ───────────────────────────────────────
 int pq_close(police_queue_t *pq) {
+    if (pq->ring) {
+        int ret = munmap(pq->ring, pq->ring_bytes);
+        pq->ring = NULL;
+        return ret;
+    }
     return mq_close(pq->mq);
 }
 // MAYS FRI S
@@ -95,5 +386,5 @@ int gui_pq_open(police_queue_t *pq, const char *name) {
     return pq_open(pq, name);
 }
 int gui_pq_send(police_queue_t *pq, const gui_msg_t *msg) {
-    return mq_send(pq->mq, (const char*)msg, sizeof(*msg), 0);
+    return pq_send_raw(pq, msg, sizeof(*msg));
 }
@@ -3,20 +3,26 @@
 
 #include <mqueue.h>
 #include <pthread.h>     // ✅ Required for pthread_rwlock_t
-#include <semaphore.h>
+#include <sched.h>
+#include <stddef.h>
+#include <stdio.h>
 #include <stdint.h>
+#include <stdatomic.h>
+#include <stdlib.h>
 #include <sys/mman.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <string.h>
 #include <errno.h>
+#include <signal.h>
 #include "config.h"      // ✅ Brings in Config definition
+#include "rng.h"         // rng_t, per-thread random streams
+#include "simclock.h"    // sim_clock_t, the shared simulated clock
 #include <stdbool.h>   // for bool
 
 #define SHM_NAME   "/ocf_sim_shm"
 #define MAX_GANGS  100
 #define MAX_MEMBERS_PER_GANG 256
-#define MAX_INTELS_PER_THREAD  50
 
 #ifndef NUM_MISSIONS
 #define NUM_MISSIONS 7
@@ -27,39 +33,47 @@ typedef struct transmission {
     int        to;         // receiver thread id
     time_t     ts;         // timestamp
     struct transmission *next;
+    struct transmission *next_from;   // next send of the same intel by `from`
 } transmission_t;
 
 typedef struct intel {
-    char            *text;     // pointer to the intel string
+    const char     *text;     // pointer to the intel string
     transmission_t *history;   // head of singly‐linked list of events
 } intel_t;
+// REGION-0..2 fields are C11 atomics; touch them only through the
+// accessors at the end of this header.
+
 // ───────────── REGION-0 : global scoreboard ─────────────
 typedef struct {
-    uint32_t plans_thwarted;
-    uint32_t plans_success;
-    uint32_t agents_executed;
+    _Atomic uint32_t plans_thwarted;
+    _Atomic uint32_t plans_success;
 } scoreboard_t;
 
 // ───────────── REGION-1 : gang state (one per gang) ─────
 typedef struct {
-    uint32_t members_alive;
-    uint32_t next_mission_id;
-    uint8_t  jailed;
-    uint8_t  prison_sentence_duration;    // seconds to hold them;
+    _Atomic uint32_t members_alive;
+    _Atomic uint32_t next_mission_id;
+    _Atomic uint8_t  jailed;
+    _Atomic uint8_t  prison_sentence_duration;    // seconds to hold them;
 } gang_state_t;
 
 // ───────────── REGION-2 : police findings ───────────────
 typedef struct {
-    uint32_t tips_waiting;
-    uint32_t arrests_made;
+    _Atomic uint32_t tips_waiting;
+    _Atomic uint32_t arrests_made;
 } police_state_t;
 
 
 // ───────────── Message Queue Structure ─────────────
+// One handle for either transport (see pq_create): mq is -1 when the queue
+// is an shm ring, ring is NULL when it is a POSIX message queue.
+struct shm_ring;
 typedef struct {
     mqd_t   mq;              // POSIX message queue descriptor
     size_t  msg_size;        // Max message size
     char    name[100];        // Queue name for logs
+    struct shm_ring *ring;   // mapped ring segment
+    size_t  ring_bytes;      // size of that mapping
 } police_queue_t;// hala***************************************************************************************************************
 ////////////////////////    MAYS ADDED   S   //////////////////
 typedef enum {
@@ -68,19 +82,67 @@ typedef enum {
     ARREST_ALL   // ← new full-gang arrest
 } police_action_t;
 
+// Packed to 16 bytes so the police queue holds many more reports for the
+// same kernel budget; intel travels as an intel_code_t, never as text.
 typedef struct {
-    police_action_t action;     // INFO, THWART, or ARREST_ALL
-    int            gang_id;
-    int            member_id;
-    char           mission[100]; // <<— add this
+    uint8_t        action;        // police_action_t: INFO, THWART, or ARREST_ALL
+    uint8_t        gang_id;
+    uint16_t       member_id;
+    intel_code_t   intel;         // reported snippet; ARREST_ALL carries the crime
+    uint16_t       num_to_arrest;
+    float          confidence;
     bool           is_correct;
     bool           is_crime;
-    double         confidence;
-    int            num_to_arrest;
 } police_report_t;
+_Static_assert(sizeof(police_report_t) == 16, "police_report_t must stay 16 bytes");
+
+// Every message on the police queue is a frame of 1..MAX_REPORT_BATCH
+// reports; only the used part of `reports` is sent.
+#define MAX_REPORT_BATCH 32
+typedef struct {
+    uint16_t        count;
+    uint16_t        reserved[3];
+    police_report_t reports[MAX_REPORT_BATCH];
+} police_batch_t;
+#define POLICE_BATCH_BYTES(n) (offsetof(police_batch_t, reports) + (size_t)(n) * sizeof(police_report_t))
 
 ////////////////////////    MAYS ADDED   E   //////////////////
 
+// ───────────── Intel bitset ─────────────
+// One bit per intel code, so "seen it already?" and "how much of crime c
+// do I know?" are a bit test and a masked popcount.
+#define INTEL_SET_WORDS ((MAX_INTEL_CODES + 63) / 64)
+_Static_assert(MAX_INTEL_CODES <= 128, "intel_set_t is sized for at most 128 intel codes");
+
+typedef struct {
+    uint64_t w[INTEL_SET_WORDS];
+} intel_set_t;
+
+// sets the bit for `code`; returns 1 if it was not set before
+static inline int intel_set_add(intel_set_t *s, intel_code_t code) {
+    uint64_t bit = 1ULL << (code & 63);
+    uint64_t *w = &s->w[code >> 6];
+    if (*w & bit)
+        return 0;
+    *w |= bit;
+    return 1;
+}
+
+// number of known snippets that belong to `crime`
+static inline int intel_set_count_crime(const intel_set_t *s, int crime) {
+    int lo = INTEL_CODE(crime, 0), hi = lo + MAX_INTEL_ENTRIES; // [lo, hi)
+    int n = 0;
+    for (int i = lo >> 6; i <= (hi - 1) >> 6; i++) {
+        uint64_t mask = ~0ULL;
+        if (i == lo >> 6)
+            mask &= ~0ULL << (lo & 63);
+        if (i == (hi - 1) >> 6 && (hi & 63))
+            mask &= ~0ULL >> (64 - (hi & 63));
+        n += __builtin_popcountll(s->w[i] & mask);
+    }
+    return n;
+}
+
 typedef struct {
     int id;
     int gang_id;
@@ -89,12 +151,14 @@ typedef struct {
     int leader_id;  // ✅ FIXED
     int leader_rank;
     const char* mission_name;//-Talin SUN
-    const char *intel_list[MAX_INTELS_PER_THREAD];//-Talin SUN
+    intel_set_t intel_seen;    // every intel code received so far
+    intel_code_t last_intel;   // the newest of them
     int intel_count;//-Talin SUN
     int has_new_intel;// if a member thrad has gotten any new intel
     int leader_intel_used[MAX_INTEL_ENTRIES];// keep track of intel that leader sent
     int is_agent;
-    pthread_barrier_t *barrier;
+    struct task_barrier *barrier;   // mission barrier (executor.h)
+    struct gang_ctx *gang;          // owning gang (gang_process.c)
     int prep_ticks;
     int prep_interval_us;
     int mission_duration_s;
@@ -102,9 +166,12 @@ typedef struct {
     float send_prob;//_Taleen added SAT
     double credibility;  // 0.0 - 1.0 range // added MAYS
     police_queue_t* pq;  // ✅ Add this line
+    rng_t rng;           // this thread's (or task's) random stream
     //ADDED HALA
     float crime_knowledge[NUM_MISSIONS]; // نسبة معرفة العميل بكل جريمة
     int is_dead;  //  added halaaaaaaaaaaaaaaaa
+    volatile sig_atomic_t freeze; // arrest hold requested (SIGUSR2 for threads)
+    struct send_backlog *backlog; // QUEUE_BLOCK sends a task could not wait for (gang_process.c)
     int *peers;       // array of peer IDs
     int peer_count;   // number of peers at this rank
     double peer_prob; // probability of sending to a peer
@@ -113,18 +180,108 @@ typedef struct {
 } thread_args_t;
 //───────────────────────────── inner mesg queues structure────────────────Talin SAT
 typedef struct {
-  int   from_id;
-  time_t timestamp;
-  char  text[128];
+  int          from_id;
+  time_t       timestamp;
+  intel_code_t intel;
 } message_t;
 
+// Lock-free bounded MPSC ring (Vyukov sequence slots). Any thread may
+// push; only the owning member pops. Each slot's seq tells producers and
+// the consumer whose turn it is, so tickets are handed out in order and
+// FIFO ordering is preserved. mtx/cond are only used to park a consumer
+// blocked in receive_message(); the fast paths never take them.
 typedef struct {
+  _Atomic size_t   seq;
+  message_t        msg;
+} msg_slot_t;
+
+typedef struct {
+  msg_slot_t      *slots;
+  size_t           mask;       // capacity - 1; capacity is a power of two
+  _Atomic size_t   head;       // next ticket to consume
+  _Atomic size_t   tail;       // next ticket to produce
+  _Atomic int      sleeping;   // consumer is parked on cond
   pthread_mutex_t  mtx;
   pthread_cond_t   cond;
-  message_t       *fifo;
-  int              head, tail, capacity;
+  _Atomic uint32_t *overflow;  // → per_gang queue_overflow slot for this member
+  _Atomic uint32_t *hwm;       // → per_gang queue_hwm slot for this member
 } msg_queue_t;
 
+// capacity is rounded up to the next power of two
+static inline int msgq_init(msg_queue_t *q, size_t capacity) {
+    size_t cap = 2; // a one-slot ring cannot tell full from empty
+    while (cap < capacity) cap <<= 1;
+    q->slots = malloc(cap * sizeof *q->slots);
+    if (!q->slots) return -1;
+    for (size_t i = 0; i < cap; ++i)
+        atomic_init(&q->slots[i].seq, i);
+    q->mask = cap - 1;
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    atomic_init(&q->sleeping, 0);
+    pthread_mutex_init(&q->mtx, NULL);
+    // timed waits take CLOCK_MONOTONIC deadlines
+    pthread_condattr_t ca;
+    pthread_condattr_init(&ca);
+    pthread_condattr_setclock(&ca, CLOCK_MONOTONIC);
+    pthread_cond_init(&q->cond, &ca);
+    pthread_condattr_destroy(&ca);
+    return 0;
+}
+
+// unread messages currently in the ring
+static inline size_t msgq_depth(msg_queue_t *q) {
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    return tail - head;
+}
+
+// returns 1 on success, 0 if the ring is full
+static inline int msgq_push(msg_queue_t *q, const message_t *m) {
+    size_t pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    msg_slot_t *slot;
+    for (;;) {
+        slot = &q->slots[pos & q->mask];
+        size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&q->tail, &pos, pos + 1,
+                    memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            return 0;
+        } else {
+            pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+        }
+    }
+    slot->msg = *m;
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+    return 1;
+}
+
+// returns 1 if a message was dequeued into *out, 0 if the ring is empty
+static inline int msgq_pop(msg_queue_t *q, message_t *out) {
+    size_t pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+    msg_slot_t *slot;
+    for (;;) {
+        slot = &q->slots[pos & q->mask];
+        size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&q->head, &pos, pos + 1,
+                    memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            return 0;
+        } else {
+            pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+        }
+    }
+    *out = slot->msg;
+    atomic_store_explicit(&slot->seq, pos + q->mask + 1, memory_order_release);
+    return 1;
+}
+
 // global, sized to NUM_MEMBERS after you know it
 //static msg_queue_t *queues;   ///EDITED MAYS
 
@@ -135,30 +292,48 @@ typedef struct {
     char event[32]; // "UPDATE_SUSPICION", "ARREST_ALL", etc.
 } gui_msg_t;
 
+// ───────────── per-gang block ─────────────
+// Everything one gang's process writes lives in its own block, aligned to
+// a cache line so that writes by neighbouring gangs never share a line.
+// The small header (lock, state, suspicion, pid) is the hot part; the
+// per-member tables follow it.
+#define SHM_CACHELINE 64
+
+typedef struct {
+    _Atomic uint32_t seq;             // seqlock: odd while a writer is inside
+    gang_state_t state;               // REGION-1
+    _Atomic double suspicion;         // cumulative suspicion, written by police
+    pid_t        pid;                 // process hosting this gang
+    _Atomic uint32_t arrests_taken;   // SIGUSR1 arrests its process has handled
+    _Atomic int ranks[MAX_MEMBERS_PER_GANG];
+    _Atomic int prep_levels[MAX_MEMBERS_PER_GANG];
+    _Atomic int member_dead[MAX_MEMBERS_PER_GANG]; // 0 = alive, 1 = dead
+    // member queue accounting: messages lost/delayed on a full queue and
+    // the deepest the queue has ever been
+    _Atomic uint32_t queue_overflow[MAX_MEMBERS_PER_GANG];
+    _Atomic uint32_t queue_hwm[MAX_MEMBERS_PER_GANG];
+} __attribute__((aligned(SHM_CACHELINE))) gang_shm_t;
+_Static_assert(sizeof(gang_shm_t) % SHM_CACHELINE == 0, "gang_shm_t must fill whole cache lines");
+
 // ───────────────── overall shared block ─────────────────
+// Read-mostly data first; each writable region starts on its own line.
 typedef struct {
     pthread_rwlock_t  rwlock;
+    Config cfg;                          // REGION-3: full config struct
+    sim_clock_t clock;                   // started by HQ before any child
+    _Atomic int run_over;                // set by HQ once it starts shutting the run down
 
-    sem_t sem_score;
-    sem_t sem_gang[MAX_GANGS];
-    sem_t sem_police;
-    sem_t sem_cfg;
+    _Alignas(SHM_CACHELINE) scoreboard_t score; // REGION-0
 
-    scoreboard_t score;                  // REGION-0
-    gang_state_t gang[MAX_GANGS];        // REGION-1
-    police_state_t police;               // REGION-2
-    double    suspicion[MAX_GANGS]; // ← new: cumulative suspicion per gang ///ADDED
-    Config cfg;                          // REGION-3: full config struct
-    // ✅ Add these:
-    int gang_ranks[MAX_GANGS][MAX_MEMBERS_PER_GANG];
-    int gang_prep_levels[MAX_GANGS][MAX_MEMBERS_PER_GANG];
-    pid_t gang_pids[MAX_GANGS];
-   // int prison_time_remaining[MAX_GANGS];
-    int gang_member_dead[MAX_GANGS][MAX_MEMBERS_PER_GANG]; // 0 = alive, 1 = dead
+    _Alignas(SHM_CACHELINE) police_state_t police; // REGION-2
 
+    gang_shm_t per_gang[MAX_GANGS];      // REGION-1, one block per gang
 } shm_layout_t;
 
 
+// one virtual-clock party per gang process, plus the police brain
+_Static_assert(SIM_MAX_PARTIES >= MAX_GANGS + 1, "SIM_MAX_PARTIES too small");
+
 #define SHM_SIZE   ((off_t)sizeof(shm_layout_t))
 
 // ───────────── Shared memory helpers ─────────────
@@ -178,12 +353,6 @@ static inline shm_layout_t* shm_parent_create(void) {
     pthread_rwlockattr_setpshared(&rwattr, PTHREAD_PROCESS_SHARED);
     pthread_rwlock_init(&p->rwlock, &rwattr);
 
-    sem_init(&p->sem_score, 1, 1);
-    for (int i = 0; i < MAX_GANGS; ++i)
-        sem_init(&p->sem_gang[i], 1, 1);
-    sem_init(&p->sem_police, 1, 1);
-    sem_init(&p->sem_cfg, 1, 1);
-
     return p;
 }
 
@@ -197,30 +366,193 @@ static inline shm_layout_t* shm_child_attach(void) {
 }
 
 // ───────────── Convenience wrappers ─────────────
-static inline void score_inc_plans_thwarted(shm_layout_t *shm) {
-    sem_wait(&shm->sem_score);
-    shm->score.plans_thwarted++;
-    sem_post(&shm->sem_score);
+// One atomic load, store or RMW each; no semaphore round trip. Relaxed
+// ordering throughout: every field is an independent counter or flag
+// that readers only display or compare against a threshold.
+#define SHM_LOAD(p)      atomic_load_explicit((p), memory_order_relaxed)
+#define SHM_STORE(p, v)  atomic_store_explicit((p), (v), memory_order_relaxed)
+#define SHM_ADD(p, v)    atomic_fetch_add_explicit((p), (v), memory_order_relaxed)
+
+// scoreboard — the increments return the new total
+static inline uint32_t score_inc_plans_thwarted(shm_layout_t *shm) {
+    return SHM_ADD(&shm->score.plans_thwarted, 1) + 1;
+}
+static inline uint32_t score_inc_plans_success(shm_layout_t *shm) {
+    return SHM_ADD(&shm->score.plans_success, 1) + 1;
+}
+static inline uint32_t score_get_plans_thwarted(shm_layout_t *shm) {
+    return SHM_LOAD(&shm->score.plans_thwarted);
+}
+static inline uint32_t score_get_plans_success(shm_layout_t *shm) {
+    return SHM_LOAD(&shm->score.plans_success);
+}
+
+// ───────────── Per-gang seqlock ─────────────
+// Writers to a gang's state and suspicion serialise on the sequence word
+// (CAS even → odd) and bump it again when done, so readers can take a
+// torn-free gang_snapshot() without ever blocking a writer: they just
+// retry if the sequence moved under them. The section is a spinlock
+// across processes, so it is kept to a few stores with SIGUSR1/SIGUSR2
+// blocked (no handler runs while it is held); the member tables are
+// single atomic words written outside it.
+static inline void gang_write_begin(shm_layout_t *shm, int g, sigset_t *saved) {
+    sigset_t block;
+    sigemptyset(&block);
+    sigaddset(&block, SIGUSR1);
+    sigaddset(&block, SIGUSR2);
+    pthread_sigmask(SIG_BLOCK, &block, saved);
+
+    _Atomic uint32_t *seq = &shm->per_gang[g].seq;
+    uint32_t s = SHM_LOAD(seq);
+    for (;;) {
+        if (s & 1) {
+            sched_yield();
+            s = SHM_LOAD(seq);
+        } else if (atomic_compare_exchange_weak_explicit(seq, &s, s + 1,
+                       memory_order_relaxed, memory_order_relaxed)) {
+            break;
+        }
+    }
+    atomic_thread_fence(memory_order_release); // odd seq before any data store
+}
+
+static inline void gang_write_end(shm_layout_t *shm, int g, const sigset_t *saved) {
+    atomic_fetch_add_explicit(&shm->per_gang[g].seq, 1, memory_order_release);
+    pthread_sigmask(SIG_SETMASK, saved, NULL);
+}
+
+typedef struct {
+    uint32_t members_alive;
+    uint8_t  jailed;
+    uint8_t  prison_sentence_duration;
+    double   suspicion;
+    int      ranks[MAX_MEMBERS_PER_GANG];
+    int      prep_levels[MAX_MEMBERS_PER_GANG];
+    int      member_dead[MAX_MEMBERS_PER_GANG];
+} gang_snapshot_t;
+
+// Copy gang g's header and its first `nmembers` member slots into *out.
+// The header is torn-free; each member slot is read as its own word.
+static inline void gang_snapshot(shm_layout_t *shm, int g, gang_snapshot_t *out, int nmembers) {
+    gang_shm_t *b = &shm->per_gang[g];
+    if (nmembers > MAX_MEMBERS_PER_GANG)
+        nmembers = MAX_MEMBERS_PER_GANG;
+    uint32_t s1, s2;
+    do {
+        while ((s1 = atomic_load_explicit(&b->seq, memory_order_acquire)) & 1)
+            sched_yield();
+        out->members_alive = SHM_LOAD(&b->state.members_alive);
+        out->jailed = SHM_LOAD(&b->state.jailed);
+        out->prison_sentence_duration = SHM_LOAD(&b->state.prison_sentence_duration);
+        out->suspicion = SHM_LOAD(&b->suspicion);
+        for (int i = 0; i < nmembers; i++) {
+            out->ranks[i] = SHM_LOAD(&b->ranks[i]);
+            out->prep_levels[i] = SHM_LOAD(&b->prep_levels[i]);
+            out->member_dead[i] = SHM_LOAD(&b->member_dead[i]);
+        }
+        atomic_thread_fence(memory_order_acquire);
+        s2 = SHM_LOAD(&b->seq);
+    } while (s1 != s2);
 }
 
+// gang state
 static inline void gang_set_jailed(shm_layout_t *shm, int g, int jailed) {
-    sem_wait(&shm->sem_gang[g]);
-    shm->gang[g].jailed = (uint8_t)jailed;
-    sem_post(&shm->sem_gang[g]);
+    sigset_t saved;
+    gang_write_begin(shm, g, &saved);
+    SHM_STORE(&shm->per_gang[g].state.jailed, (uint8_t)jailed);
+    gang_write_end(shm, g, &saved);
+}
+static inline void gang_set_members_alive(shm_layout_t *shm, int g, uint32_t n) {
+    sigset_t saved;
+    gang_write_begin(shm, g, &saved);
+    SHM_STORE(&shm->per_gang[g].state.members_alive, n);
+    gang_write_end(shm, g, &saved);
+}
+// a full arrest empties the gang and jails it in one step
+static inline void gang_set_arrested(shm_layout_t *shm, int g) {
+    sigset_t saved;
+    gang_write_begin(shm, g, &saved);
+    SHM_STORE(&shm->per_gang[g].state.members_alive, 0);
+    SHM_STORE(&shm->per_gang[g].state.jailed, 1);
+    gang_write_end(shm, g, &saved);
+}
+// released from jail with a clean slate
+static inline void gang_set_released(shm_layout_t *shm, int g) {
+    sigset_t saved;
+    gang_write_begin(shm, g, &saved);
+    SHM_STORE(&shm->per_gang[g].state.jailed, 0);
+    SHM_STORE(&shm->per_gang[g].suspicion, 0.0);
+    gang_write_end(shm, g, &saved);
 }
 
+// per-member tables
+static inline void gang_set_member(shm_layout_t *shm, int g, int m, int rank, int level) {
+    SHM_STORE(&shm->per_gang[g].ranks[m], rank);
+    SHM_STORE(&shm->per_gang[g].prep_levels[m], level);
+}
+static inline void gang_set_prep_level(shm_layout_t *shm, int g, int m, int level) {
+    SHM_STORE(&shm->per_gang[g].prep_levels[m], level);
+}
+
+// suspicion — writers are serialised by the seqlock, so scaling is a
+// plain load/store rather than a CAS loop
+static inline double gang_get_suspicion(shm_layout_t *shm, int g) {
+    return SHM_LOAD(&shm->per_gang[g].suspicion);
+}
+static inline void gang_set_suspicion(shm_layout_t *shm, int g, double s) {
+    sigset_t saved;
+    gang_write_begin(shm, g, &saved);
+    SHM_STORE(&shm->per_gang[g].suspicion, s);
+    gang_write_end(shm, g, &saved);
+}
+static inline double gang_scale_suspicion(shm_layout_t *shm, int g, double factor) {
+    sigset_t saved;
+    gang_write_begin(shm, g, &saved);
+    double s = SHM_LOAD(&shm->per_gang[g].suspicion) * factor;
+    SHM_STORE(&shm->per_gang[g].suspicion, s);
+    gang_write_end(shm, g, &saved);
+    return s;
+}
+
+// police findings
 static inline uint32_t police_get_tips(shm_layout_t *shm) {
-    uint32_t v;
-    sem_wait(&shm->sem_police);
-    v = shm->police.tips_waiting;
-    sem_post(&shm->sem_police);
-    return v;
+    return SHM_LOAD(&shm->police.tips_waiting);
 }
+static inline uint32_t police_get_arrests(shm_layout_t *shm) {
+    return SHM_LOAD(&shm->police.arrests_made);
+}
+// Agent reports go to one ingest queue per gang, drained only by that
+// gang's police listener. Police→referee orders (THWART / ARREST_ALL)
+// never share a queue with tips: they travel one police_report_t per
+// message on the control channel, always a POSIX queue whatever
+// report_transport says, so that arrests overtake thwarts by priority.
+#define CTRL_QUEUE_NAME   "/ocf_sim_ctrl"
+#define CTRL_QUEUE_DEPTH  10              // within the default msg_max
+#define CTRL_PRIO_THWART  1
+#define CTRL_PRIO_ARREST  2
+static inline void police_ingest_name(char *buf, size_t n, int gang_id) {
+    snprintf(buf, n, "/ocf_sim_police_g%d", gang_id);
+}
+
+// HQ creates each queue once (transport = report_transport_t, depth in
+// messages) and removes it at shutdown; everyone else just opens it by
+// name and gets whichever transport HQ picked.
+int pq_create(const char *name, size_t msg_size, long depth, int transport);
+void pq_unlink(const char *name);
 // 🟩 Add this declaration if not already declared above
 int pq_open(police_queue_t* pq, const char* name);
 int pq_close(police_queue_t* pq);
-int pq_send(police_queue_t* pq, const police_report_t* msg);
-int pq_recv(police_queue_t *pq, police_report_t *report_out);
+int pq_send(police_queue_t* pq, const police_report_t* msg);   // a frame of one
+int pq_send_batch(police_queue_t *pq, const police_batch_t *batch);
+int pq_recv_batch(police_queue_t *pq, police_batch_t *batch_out); // → report count
+// Control channel: ctrl_send backs off 1 ms at a time while the queue is
+// full, for at most CTRL_SEND_RETRIES tries, and gives up at once
+// (ESHUTDOWN) when *run_over says no referee is left to read it; a
+// timeout fails with ETIMEDOUT. ctrl_recv blocks for the highest-priority
+// order.
+#define CTRL_SEND_RETRIES 2000
+int ctrl_send(police_queue_t *pq, const police_report_t *order, const _Atomic int *run_over);
+int ctrl_recv(police_queue_t *pq, police_report_t *order_out);
 //__Talin
 int pq_open_read(police_queue_t *pq, const char *name);
 //-end Talin
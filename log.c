@@ -0,0 +1,207 @@
+/* file: log.c */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "log.h"
+
+#define LOG_RING_BYTES  (64 * 1024)  // per thread, power of two
+#define LOG_FLUSH_MS    20
+#define LOG_FULL_SPINS  1000         // yields before a message is dropped
+
+int log_level = LOG_INFO;
+
+// ───── Per-thread ring ─────
+// Single producer (the owning thread) and single consumer (whoever holds
+// drain_mtx). head/tail are running byte counts. A thread that exits
+// marks its ring orphaned; the ring is freed once drained.
+typedef struct log_ring {
+    struct log_ring *next;            // registry, under reg_mtx
+    _Atomic size_t   head;            // bytes consumed
+    _Atomic size_t   tail;            // bytes produced
+    _Atomic int      orphaned;
+    char             data[LOG_RING_BYTES];
+} log_ring_t;
+
+static pthread_mutex_t reg_mtx = PTHREAD_MUTEX_INITIALIZER;
+static log_ring_t     *rings;
+static pthread_key_t   ring_key;
+static pthread_once_t  key_once = PTHREAD_ONCE_INIT;
+static __thread log_ring_t *my_ring;
+
+static pthread_mutex_t drain_mtx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t wake_mtx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  wake_cond;
+static pthread_t       flusher;
+static _Atomic int     running;
+static _Atomic unsigned long dropped;
+
+static void ring_orphan(void *p)
+{
+    atomic_store_explicit(&((log_ring_t *)p)->orphaned, 1, memory_order_release);
+}
+
+static void make_key(void)
+{
+    pthread_key_create(&ring_key, ring_orphan);
+}
+
+static log_ring_t *ring_get(void)
+{
+    if (my_ring)
+        return my_ring;
+    log_ring_t *r = calloc(1, sizeof *r);
+    if (!r)
+        return NULL;
+    pthread_once(&key_once, make_key);
+    pthread_setspecific(ring_key, r);
+    pthread_mutex_lock(&reg_mtx);
+    r->next = rings;
+    rings = r;
+    pthread_mutex_unlock(&reg_mtx);
+    return my_ring = r;
+}
+
+static void wake_flusher(void)
+{
+    pthread_mutex_lock(&wake_mtx);
+    pthread_cond_signal(&wake_cond);
+    pthread_mutex_unlock(&wake_mtx);
+}
+
+// Copy every ring's pending bytes to stdout and free drained orphans
+static void drain_all(void)
+{
+    pthread_mutex_lock(&drain_mtx);
+    pthread_mutex_lock(&reg_mtx);
+    for (log_ring_t **pp = &rings; *pp;)
+    {
+        log_ring_t *r = *pp;
+        int orphaned = atomic_load_explicit(&r->orphaned, memory_order_acquire);
+        size_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+        size_t tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+        if (tail != head)
+        {
+            size_t off = head & (LOG_RING_BYTES - 1);
+            size_t len = tail - head;
+            size_t first = len < LOG_RING_BYTES - off ? len : LOG_RING_BYTES - off;
+            fwrite(r->data + off, 1, first, stdout);
+            fwrite(r->data, 1, len - first, stdout);
+            atomic_store_explicit(&r->head, tail, memory_order_release);
+        }
+        if (orphaned)
+        {
+            *pp = r->next;
+            free(r);
+            continue;
+        }
+        pp = &r->next;
+    }
+    pthread_mutex_unlock(&reg_mtx);
+    unsigned long lost = atomic_exchange(&dropped, 0);
+    if (lost)
+        printf("[log] %lu message(s) dropped, ring full\n", lost);
+    fflush(stdout);
+    pthread_mutex_unlock(&drain_mtx);
+}
+
+static void *flusher_main(void *arg)
+{
+    (void)arg;
+    while (atomic_load(&running))
+    {
+        struct timespec deadline;
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_nsec += LOG_FLUSH_MS * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        pthread_mutex_lock(&wake_mtx);
+        pthread_cond_timedwait(&wake_cond, &wake_mtx, &deadline);
+        pthread_mutex_unlock(&wake_mtx);
+        drain_all();
+    }
+    return NULL;
+}
+
+static void log_shutdown(void)
+{
+    if (atomic_exchange(&running, 0))
+    {
+        wake_flusher();
+        pthread_join(flusher, NULL);
+    }
+    drain_all();
+}
+
+void log_init(int verbosity)
+{
+    log_level = verbosity < LOG_ERROR ? LOG_ERROR : verbosity > LOG_TRACE ? LOG_TRACE : verbosity;
+    pthread_condattr_t ca;
+    pthread_condattr_init(&ca);
+    pthread_condattr_setclock(&ca, CLOCK_MONOTONIC);
+    pthread_cond_init(&wake_cond, &ca);
+    pthread_condattr_destroy(&ca);
+    atomic_store(&running, 1);
+    if (pthread_create(&flusher, NULL, flusher_main, NULL) != 0)
+    {
+        perror("log: pthread_create flusher");
+        atomic_store(&running, 0); // log_write falls back to stdio
+        return;
+    }
+    atexit(log_shutdown);
+}
+
+void log_write(const char *fmt, ...)
+{
+    char line[LOG_LINE_MAX];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(line, sizeof line, fmt, ap);
+    va_end(ap);
+    if (n < 0)
+        return;
+    if (n >= (int)sizeof line)
+        n = sizeof line - 1;
+
+    log_ring_t *r = atomic_load_explicit(&running, memory_order_relaxed) ? ring_get() : NULL;
+    if (!r)
+    {
+        // before log_init, after shutdown, or out of memory
+        fwrite(line, 1, n, stdout);
+        return;
+    }
+
+    size_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    for (int spin = 0;; spin++)
+    {
+        size_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+        if (LOG_RING_BYTES - (tail - head) >= (size_t)n)
+            break;
+        if (spin == 0)
+            wake_flusher();
+        if (spin == LOG_FULL_SPINS)
+        {
+            atomic_fetch_add(&dropped, 1);
+            return;
+        }
+        sched_yield();
+    }
+    size_t off = tail & (LOG_RING_BYTES - 1);
+    size_t first = (size_t)n < LOG_RING_BYTES - off ? (size_t)n : LOG_RING_BYTES - off;
+    memcpy(r->data + off, line, first);
+    memcpy(r->data, line + first, n - first);
+    atomic_store_explicit(&r->tail, tail + n, memory_order_release);
+}
+
+void log_flush(void)
+{
+    drain_all();
+}
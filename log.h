@@ -0,0 +1,40 @@
+/* file: log.h */
+#ifndef LOG_H
+#define LOG_H
+
+// ───────────── Asynchronous logging ─────────────
+// LOG(level, fmt, ...) formats into the calling thread's own ring buffer;
+// a background flusher drains every ring to stdout in large writes, so
+// hot loops never take the stdout lock or issue a write. Levels above
+// LOG_COMPILE_LEVEL compile away entirely; levels above the runtime level
+// (cfg.logging_verbosity) cost one load and compare, and their arguments
+// are never evaluated.
+
+typedef enum {
+    LOG_ERROR = 0,
+    LOG_WARN,
+    LOG_INFO,      // default (logging_verbosity 2)
+    LOG_DEBUG,     // per-tick chatter: intel hops, prep ticks, score tables
+    LOG_TRACE
+} log_level_t;
+
+#define LOG_LINE_MAX 1024   // longer messages are truncated
+
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL LOG_TRACE
+#endif
+
+extern int log_level;   // set once by log_init(), before any thread logs
+
+#define LOG_ENABLED(level) ((level) <= LOG_COMPILE_LEVEL && (level) <= log_level)
+#define LOG(level, ...)                 \
+    do {                                \
+        if (LOG_ENABLED(level))         \
+            log_write(__VA_ARGS__);     \
+    } while (0)
+
+void log_init(int verbosity);   // start the flusher; everything is flushed at exit
+void log_write(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+void log_flush(void);           // drain everything logged so far, now (e.g. before _exit)
+
+#endif // LOG_H
@@ -5,23 +5,57 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <sys/wait.h>
+#include <signal.h>
 #include <mqueue.h>
 #include <pthread.h>
+#include <time.h>
 
 #include "config.h"    // load_config_json(), extern Config cfg
 #include "ipc_utils.h" // shm_parent_create(), shm_unlink(), SHM_NAME
 #include "ipc_utils.h" // police_report_t for mq attributes
+#include "evlog.h"     // evlog_create(), EVLOG_PATH
 
 #define POLICE_BIN "./police_process"
 #define GANG_BIN "./gang_process"
 #define GUI_BIN "./gui"
-#define MQ_NAME "/ocf_sim_police"
 
 #define GUI_QUEUE_NAME  "/ocf_sim_gui"   //////MAYS ADDED FRI
 static police_queue_t gui_queue;   // global handle for incoming GUI notifications
 
 // ─── Referee listener ───
 static void* referee_thread(void* arg);
+// ─── Ends the run after max_simulation_runtime_s simulated seconds ───
+static void* runtime_thread(void* arg);
+// ─── Moves virtual time (clock_mode "virtual"), limit included ───
+static void* vclock_thread(void* arg);
+
+// gang pids live in shm->per_gang[].pid
+static pid_t police_pid, gui_pid;
+
+// Every way a run can end comes through here: mark it over and SIGTERM
+// every child; main() reaps them and removes the IPC objects.
+static void end_run(shm_layout_t *shm)
+{
+    if (atomic_exchange(&shm->run_over, 1))
+        return;
+    for (int g = 0; g < shm->cfg.num_gangs; g++)
+        if (shm->per_gang[g].pid > 0)
+            kill(shm->per_gang[g].pid, SIGTERM);
+    if (police_pid > 0)
+        kill(police_pid, SIGTERM);
+    if (gui_pid > 0)
+        kill(gui_pid, SIGTERM);
+}
+
+// remove the ingest queues of gangs 0 … n-1
+static void unlink_ingest_queues(int n)
+{
+    char name[64];
+    while (n-- > 0) {
+        police_ingest_name(name, sizeof name, n);
+        pq_unlink(name);
+    }
+}
 
 // fork & exec a child, returning its pid
 static pid_t spawn_child(const char *path, char *const argv[])
@@ -60,7 +94,7 @@ int main(int argc, char **argv)
 
     print_config();
 
-    // 2) Create & initialize shared memory + semaphores + rwlock
+    // 2) Create & initialize shared memory + rwlock
     shm_layout_t *shm = shm_parent_create();
     if (!shm)
     {
@@ -68,62 +102,71 @@ int main(int argc, char **argv)
         return EXIT_FAILURE;
     }
 
-    // 3) Snapshot the config into shared memory
+    // random_seed 0 = pick one now; every process derives its streams from
+    // the seed in shared memory, so printing it is enough to replay a run
+    if (cfg.random_seed == 0)
+        cfg.random_seed = (int)(time(NULL) ^ getpid());
+    printf("🎲 random_seed = %d\n", cfg.random_seed);
+
+    // 3) Snapshot the config into shared memory and start the shared clock;
+    //    every child derives simulated time from this epoch and time_scale.
+    //    Virtual time moves once every gang process and the police brain
+    //    (its parties) are idle.
+    int per_proc = cfg.gangs_per_process > 0 ? cfg.gangs_per_process : 1;
     pthread_rwlock_wrlock(&shm->rwlock);
     shm->cfg = cfg;
+    sim_clock_start(&shm->clock, cfg.time_scale);
+    if (cfg.clock_mode == CLOCK_MODE_VIRTUAL)
+        sim_v_start(&shm->clock, (cfg.num_gangs + per_proc - 1) / per_proc + (cfg.police_enabled ? 1 : 0));
     pthread_rwlock_unlock(&shm->rwlock);
-
-    // 4) Create the POSIX message queue for agent→police reports
-
-    struct mq_attr attr = {
-        .mq_flags = 0,
-        .mq_maxmsg = cfg.report_batch_size,
-        .mq_msgsize = sizeof(police_report_t),
-        .mq_curmsgs = 0};
-    printf(
-        "DEBUG: mq_attr: flags=%ld, maxmsg=%ld, msgsize=%ld, curmsgs=%ld\n",
-        (long)attr.mq_flags,
-        (long)attr.mq_maxmsg,
-        (long)attr.mq_msgsize,
-        (long)attr.mq_curmsgs);
-
-// Force removal of any stale queue
-mq_unlink(MQ_NAME);
-
-// Now create it fresh with the right msgsize
-    mqd_t mq = mq_open(MQ_NAME,
-                       O_CREAT | O_RDWR,
-                       0600,
-                       &attr);
-
-    if (mq == (mqd_t)-1)
+    if (shm->clock.virtual_time)
+        printf("⏩ virtual time: idle stretches are skipped\n");
+    else if (shm->clock.scale != 1.0)
+        printf("⏩ time_scale = %.2fx wall clock\n", shm->clock.scale);
+
+    // 4) Create the police→referee control channel, then the agent→police
+    //    report queues and the GUI notification queue, as POSIX message
+    //    queues or shm rings (report_transport)
+    if (pq_create(CTRL_QUEUE_NAME, sizeof(police_report_t), CTRL_QUEUE_DEPTH, TRANSPORT_MQUEUE) == -1)
     {
-        perror("mq_open here in main line 96");
+        perror("pq_create control channel");
         shm_unlink(SHM_NAME);
         return EXIT_FAILURE;
     }
-    mq_close(mq); // children will reopen in send or recv mode
+    long report_depth = cfg.report_transport == TRANSPORT_SHM_RING
+                            ? (cfg.report_ring_slots > 0 ? cfg.report_ring_slots : 1024)
+                            : (cfg.report_queue_depth > 0 ? cfg.report_queue_depth : 10);
+    // one ingest queue per gang, so each police listener owns its gang;
+    // frames of up to MAX_REPORT_BATCH reports
+    for (int g = 0; g < cfg.num_gangs; g++)
+    {
+        char name[64];
+        police_ingest_name(name, sizeof name, g);
+        if (pq_create(name, sizeof(police_batch_t), report_depth, cfg.report_transport) == -1)
+        {
+            perror("pq_create gang ingest queue");
+            unlink_ingest_queues(g);
+            pq_unlink(CTRL_QUEUE_NAME);
+            shm_unlink(SHM_NAME);
+            return EXIT_FAILURE;
+        }
+    }
 
 /////////////////////MAYS FRI 
     // ─── Create GUI notification queue ───
-    mq_unlink(GUI_QUEUE_NAME);
-    struct mq_attr gui_attr = {
-        .mq_flags   = 0,
-        .mq_maxmsg  = cfg.report_batch_size,
-        .mq_msgsize = sizeof(gui_msg_t),
-        .mq_curmsgs = 0
-    };
-    mqd_t gui_mq = mq_open(GUI_QUEUE_NAME,
-                           O_CREAT | O_RDWR,
-                           0600,
-                           &gui_attr);
-    if (gui_mq == (mqd_t)-1) {
-        perror("mq_open GUI_QUEUE_NAME");
+    if (pq_create(GUI_QUEUE_NAME, sizeof(gui_msg_t), report_depth, cfg.report_transport) == -1) {
+        perror("pq_create GUI_QUEUE_NAME");
+        unlink_ingest_queues(cfg.num_gangs);
+        pq_unlink(CTRL_QUEUE_NAME);
         shm_unlink(SHM_NAME);
         return EXIT_FAILURE;
     }
-    mq_close(gui_mq);
    
+    // ─── Create the binary transmission log, one segment per gang ───
+    if (cfg.event_log_records > 0 &&
+        evlog_create(EVLOG_PATH, cfg.num_gangs, cfg.event_log_records) == -1)
+        perror("evlog_create " EVLOG_PATH " (transmissions not logged)");
+
 ////////////////////////////////////    ADDED MAYS S       /////////////////////////////
 
     // --- spawn referee ---
@@ -132,34 +175,50 @@ mq_unlink(MQ_NAME);
         perror("main: pthread_create referee");
         exit(EXIT_FAILURE);
     }
+    // with virtual time the clock keeper enforces the runtime limit too
+    int runtime_limit = cfg.max_simulation_runtime_s > 0 || shm->clock.virtual_time;
+    pthread_t runtime_thr;
+    if (runtime_limit &&
+        pthread_create(&runtime_thr, NULL, shm->clock.virtual_time ? vclock_thread : runtime_thread, shm) != 0) {
+        perror("main: pthread_create runtime");
+        exit(EXIT_FAILURE);
+    }
 
 ////////////////////////////////////    ADDED MAYS E      /////////////////////////////
 
      // ___________________________________________________________________________Talin
-    // 5a) Spawn all gang processes first, passing each gang’s numeric ID
-    for (int g = 0; g < cfg.num_gangs; g++) {
-        // 1. Build the string argument for this gang’s ID
-        char *gid_str;
-        if (asprintf(&gid_str, "%d", g) < 0) {
-            perror("asprintf");
+    // 5a) Spawn all gang processes first, passing each the numeric IDs of
+    //     the gangs it hosts (gangs_per_process of them; 1 = one process per gang)
+    int gang_procs = 0;
+    for (int first = 0; first < cfg.num_gangs; first += per_proc) {
+        int hosted = cfg.num_gangs - first < per_proc ? cfg.num_gangs - first : per_proc;
+
+        // 1. Build the string arguments for these gangs’ IDs
+        char **gang_argv = calloc(hosted + 2, sizeof(char *));
+        if (!gang_argv) {
+            perror("calloc");
             exit(EXIT_FAILURE);
         }
+        gang_argv[0] = GANG_BIN;   // "./gang_process"
+        for (int k = 0; k < hosted; k++) {
+            if (asprintf(&gang_argv[k + 1], "%d", first + k) < 0) {
+                perror("asprintf");
+                exit(EXIT_FAILURE);
+            }
+        }
 
-        // 2. Create a local argv array (in scope!)
-        char *const gang_argv[] = {
-            GANG_BIN,   // "./gang_process"
-            gid_str,    // "<g>"
-            NULL
-        };
-
-        // 3. Fork+exec the gang process
+        // 2. Fork+exec the gang process
         pid_t pid = spawn_child(GANG_BIN, gang_argv);
+        gang_procs++;
 
-        // 4. Record its PID into shared memory so Brain can signal it later
-        shm->gang_pids[g] = pid;
+        // 3. Record its PID into shared memory so Brain can signal it later
+        for (int k = 0; k < hosted; k++)
+            shm->per_gang[first + k].pid = pid;
 
-        // 5. Clean up our temporary string
-        free(gid_str);
+        // 4. Clean up our temporary strings
+        for (int k = 1; k <= hosted; k++)
+            free(gang_argv[k]);
+        free(gang_argv);
     }
 
 
@@ -186,35 +245,55 @@ mq_unlink(MQ_NAME);
     }
     police_argv[idx] = NULL; // argv must be NULL-terminated
 
-    spawn_child(POLICE_BIN, police_argv);
+    if (cfg.police_enabled)
+        police_pid = spawn_child(POLICE_BIN, police_argv);
 
 ////////////////////////////////////    ADDED MAYS S       /////////////////////////////
-    // 5c) Referee: open the police queue for listening to arrest orders
+    // 5c) Referee: open the control channel for listening to arrest orders
     police_queue_t referee_pq;
-    if (pq_open_read(&referee_pq, MQ_NAME) < 0) {
+    if (pq_open_read(&referee_pq, CTRL_QUEUE_NAME) < 0) {
         perror("[Referee] pq_open_read");
         exit(EXIT_FAILURE);
     }
 
 ///////////////////////////////////    ADDED MAYS E      /////////////////////////////
 char *const gui_argv[] = { GUI_BIN, NULL }; /// added by mayar spawn gui 
-    spawn_child(GUI_BIN, gui_argv);
+    gui_pid = spawn_child(GUI_BIN, gui_argv);
 //______________________________________________________________________end Talin
-    // 6) Wait for all child processes
+    // 6) Wait for all child processes; once every gang process has
+    //    finished its missions the run is over
     int status;
-    while (wait(&status) > 0)
+    pid_t pid;
+    while ((pid = wait(&status)) > 0)
     {
-        // optionally log child exit statuses
+        for (int g = 0; g < cfg.num_gangs; g++)
+        {
+            if (shm->per_gang[g].pid != pid)
+                continue;
+            if (--gang_procs == 0 && !atomic_load(&shm->run_over))
+            {
+                printf("🏁 Every gang finished its missions → shutting down simulation\n");
+                end_run(shm);
+            }
+            break;
+        }
     }
 ////////////////////////////////////    ADDED MAYS S      /////////////////////////////
-   // All children have exited → stop the referee thread
+   // All children have exited → stop the referee and runtime threads
    pthread_cancel(ref_thr);
    pthread_join(ref_thr, NULL);
+   if (runtime_limit) {
+       if (!shm->clock.virtual_time) // the keeper returns once run_over is set
+           pthread_cancel(runtime_thr);
+       pthread_join(runtime_thr, NULL);
+   }
 
 ////////////////////////////////////    ADDED MAYS E      /////////////////////////////
 
     // 7) Cleanup IPC
-    mq_unlink(MQ_NAME);
+    pq_unlink(CTRL_QUEUE_NAME);
+    pq_unlink(GUI_QUEUE_NAME);
+    unlink_ingest_queues(cfg.num_gangs);
     if (shm_unlink(SHM_NAME) == -1)
     {
         perror("shm_unlink");
@@ -225,56 +304,76 @@ char *const gui_argv[] = { GUI_BIN, NULL }; /// added by mayar spawn gui
 }
 ////////////////////////////////////    ADDED MAYS  S      /////////////////////////////
 
-// Referee thread: receive police_report_t and act on ARREST_ALL / THWART
+// Referee thread: receive police orders and act on ARREST_ALL / THWART
 static void *referee_thread(void *arg) {
     shm_layout_t    *shm = (shm_layout_t*)arg;
     police_queue_t   pq;
 
-    if (pq_open_read(&pq, MQ_NAME) < 0) {
+    if (pq_open_read(&pq, CTRL_QUEUE_NAME) < 0) {
         perror("referee: pq_open_read");
         return NULL;
     }
 
     while (1) {
         police_report_t rpt;
-        ssize_t n = pq_recv(&pq, &rpt);
-        if (n == -1 && errno == EINTR) continue;
-        if (n != sizeof(rpt)) {
-            if (n == -1) perror("referee: pq_recv");
+        if (ctrl_recv(&pq, &rpt) == -1) {
+            if (errno == EBADMSG) {
+                sim_v_done(&shm->clock); // an order all the same
+                continue;
+            }
+            if (errno == EINTR) continue;
+            perror("referee: ctrl_recv");
             break;
         }
 
         switch (rpt.action) {
           case THWART:
             // partial: jail top leader only
-            sem_wait(&shm->sem_gang[rpt.gang_id]);
-              shm->gang[rpt.gang_id].jailed = 1;
-              shm->score.plans_thwarted++;
-            sem_post(&shm->sem_gang[rpt.gang_id]);
+            gang_set_jailed(shm, rpt.gang_id, 1);
+            score_inc_plans_thwarted(shm);
             break;
 
           case ARREST_ALL:
             // full gang arrest
-            sem_wait(&shm->sem_gang[rpt.gang_id]);
-              shm->gang[rpt.gang_id].members_alive = 0;
-              shm->gang[rpt.gang_id].jailed       = 1;
-              shm->score.plans_thwarted++;
-                     // if we’ve thwarted enough plans, shut down the HQ
-         if (shm->score.plans_thwarted >= shm->cfg.max_thwarted_plans) {
-             printf("🚨 Reached max_thwarted_plans=%d → shutting down simulation\n",
-                    shm->cfg.max_thwarted_plans);
-             exit(0);
-         }
-            sem_post(&shm->sem_gang[rpt.gang_id]);
+            gang_set_arrested(shm, rpt.gang_id);
+            // if we’ve thwarted enough plans, shut down the HQ
+            if (score_inc_plans_thwarted(shm) >= (uint32_t)shm->cfg.max_thwarted_plans) {
+                printf("🚨 Reached max_thwarted_plans=%d → shutting down simulation\n",
+                       shm->cfg.max_thwarted_plans);
+                end_run(shm);
+            }
             break;
 
           default:
             // INFO or others—no action
             break;
         }
+        sim_v_done(&shm->clock); // the police's order is dealt with
     }
 
     pq_close(&pq);
     return NULL;
 }
 ////////////////////////////////////    ADDED MAYS E      /////////////////////////////
+
+static void *runtime_thread(void *arg) {
+    shm_layout_t *shm = (shm_layout_t*)arg;
+    sim_sleep(&shm->clock, shm->cfg.max_simulation_runtime_s);
+    printf("⏰ Reached max_simulation_runtime_s=%d → shutting down simulation\n",
+           shm->cfg.max_simulation_runtime_s);
+    end_run(shm);
+    return NULL;
+}
+
+static void *vclock_thread(void *arg) {
+    shm_layout_t *shm = (shm_layout_t*)arg;
+    int64_t limit = shm->cfg.max_simulation_runtime_s > 0
+                        ? shm->cfg.max_simulation_runtime_s * 1000000000LL
+                        : SIM_NEVER;
+    if (sim_v_keep(&shm->clock, &shm->run_over, limit) == 0) {
+        printf("⏰ Reached max_simulation_runtime_s=%d → shutting down simulation\n",
+               shm->cfg.max_simulation_runtime_s);
+        end_run(shm);
+    }
+    return NULL;
+}
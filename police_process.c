@@ -3,175 +3,308 @@
 #include <stdlib.h>
 #include <errno.h>
 #include <pthread.h>
-#include <semaphore.h>
-#include "ipc_utils.h" // pq_open, pq_recv, pq_close, shm_child_attach
+#include <time.h>
+#include "ipc_utils.h" // pq_open, pq_recv_batch, pq_close, shm_child_attach
 #include "config.h"    // extern Config cfg
+#include "log.h"
 #include <signal.h>
 
-#define POLICE_QUEUE_NAME "/ocf_sim_police"
 ///////////////////////     MAYS ADDED  S      //////////////////////////////
 #define POLICE_BIN "./police_process"
 #define GANG_BIN "./gang_process"
 #define GUI_BIN "./gui"
 #define GUI_QUEUE_NAME "/ocf_sim_gui"
-// Track how many hints we’ve seen per gang per crime
-static int hint_count[MAX_GANGS][MAX_CRIMES] = {{0}};
 // How strongly misleading intel penalizes other missions
 #define MISINFO_PENALTY 0.5
 
-// Per-gang, per-mission cumulative “scores”
-static double mission_score[MAX_GANGS][MAX_CRIMES];
+// Per-gang, per-mission cumulative “scores”, padded to whole cache lines
+// of doubles so the scoring kernel runs on full vectors; lanes past
+// num_crimes stay 0. Written only by gang g's listener: the brain asks
+// for a reset through `reset` and reads the argmax the listener publishes.
+#define SCORE_LANES (SHM_CACHELINE / (int)sizeof(double))
+#define SCORE_WIDTH ((MAX_CRIMES + SCORE_LANES - 1) / SCORE_LANES * SCORE_LANES)
 typedef struct
 {
-    police_queue_t *pq;
+    _Alignas(SHM_CACHELINE) double score[SCORE_WIDTH];
+    int hint_count[MAX_CRIMES]; // hints seen per crime since the last arrest
+    _Atomic int reset;          // brain → listener: clear score[]
+    _Atomic int best;           // listener → brain: argmax of score[]
+    _Atomic double best_score;
+} gang_scores_t;
+static gang_scores_t scores[MAX_GANGS];
+
+// A batch of tips in SoA form: tip j adds add[j] to crime[j] and scales
+// every other crime by keep[j].
+typedef struct
+{
+    int n;
+    int crime[MAX_REPORT_BATCH];
+    double add[MAX_REPORT_BATCH];
+    double keep[MAX_REPORT_BATCH];
+} tip_batch_t;
+typedef struct
+{
+    police_queue_t *pq;  // this gang's ingest queue (read)
+    police_queue_t *out; // control channel to the referee (write)
     int gang_id;
     shm_layout_t *shm;
 } listen_args_t;
-// Return the index [0..num_crimes) matching this mission name
-// If you always report crime‐names (per above), you can keep the simple map:
-// new mission_index: find which crime owns this snippet
-static int mission_index(const char *snippet, shm_layout_t *shm)
+// Snippet → crime lookup, indexed by intel code (a perfect hash of the
+// snippets in shm->cfg.crimes). Built once at start-up; -1 marks codes
+// that no loaded crime owns.
+static int8_t crime_of_intel[MAX_INTEL_CODES];
+
+static void build_crime_lookup(const Config *c)
 {
-    for (int i = 0; i < shm->cfg.num_crimes; ++i)
-    {
-        Crime *c = &shm->cfg.crimes[i];
-        for (int j = 0; j < c->legit_prep_intel_count; ++j)
-        {
-            if (strcmp(c->legit_prep_intel[j], snippet) == 0)
-                return i;
-        }
-    }
-    return -1; // truly unknown
+    memset(crime_of_intel, -1, sizeof crime_of_intel);
+    for (int i = 0; i < c->num_crimes; ++i)
+        for (int j = 0; j < c->crimes[i].legit_prep_intel_count; ++j)
+            crime_of_intel[INTEL_CODE(i, j)] = (int8_t)i;
+}
+
+// Return the index [0..num_crimes) of the crime that owns this snippet
+static int mission_index(intel_code_t intel)
+{
+    if (intel >= MAX_INTEL_CODES)
+        return -1; // truly unknown
+    return crime_of_intel[intel];
 }
 
 ///////////////////////     MAYS ADDED  E      //////////////////////////////
 
-static void *listener_thread(void *vp)
+// ───── Brain events ─────
+// Listeners mark a gang dirty whenever they write its suspicion; the
+// brain sleeps until something is dirty, a jail term ends or the next
+// status report is due, and then only looks at the gangs that changed.
+// With virtual time the brain is a party on the shared clock: it idles
+// there instead of on cond, and a listener resumes it.
+static struct
 {
-    listen_args_t *a = vp;
-    police_report_t report;
-    shm_layout_t *shm = a->shm;
-    Config cfg = shm->cfg;
+    pthread_mutex_t mtx;
+    pthread_cond_t cond; // CLOCK_MONOTONIC
+    uint64_t dirty[(MAX_GANGS + 63) / 64];
+    int any;
+    sim_clock_t *clock;
+    int party; // the brain's slot on the virtual clock, -1 if none
+} brain_ev = {.mtx = PTHREAD_MUTEX_INITIALIZER, .party = -1};
+
+// before any listener starts: timed waits take CLOCK_MONOTONIC deadlines
+static void brain_events_init(void)
+{
+    pthread_condattr_t ca;
+    pthread_condattr_init(&ca);
+    pthread_condattr_setclock(&ca, CLOCK_MONOTONIC);
+    pthread_cond_init(&brain_ev.cond, &ca);
+    pthread_condattr_destroy(&ca);
+}
 
-    a->pq->msg_size = sizeof(report);
-    strncpy(a->pq->name, POLICE_QUEUE_NAME, sizeof(a->pq->name) - 1);
-    a->pq->name[sizeof(a->pq->name) - 1] = '\0'; // Ensure null-termination
-    a->pq->mq = 3; // Use the same mq as in gang_process
+static void brain_notify(int g)
+{
+    pthread_mutex_lock(&brain_ev.mtx);
+    brain_ev.dirty[g / 64] |= 1ull << (g % 64);
+    brain_ev.any = 1;
+    if (brain_ev.party >= 0)
+        sim_v_resume(brain_ev.clock, brain_ev.party); // the listener's frame keeps the clock still
+    else
+        pthread_cond_signal(&brain_ev.cond);
+    pthread_mutex_unlock(&brain_ev.mtx);
+}
 
-    printf("[Listener %d] Thread started, queue=\"%s\"\n",
-           a->gang_id, a->pq->name);
-    fflush(stdout);
+// ───── Scoring kernel ─────
+// Applies every tip to the padded row, then returns the total and the
+// argmax in one more pass. Each tip is s[k] = s[k]*mul[k] + inc[k] with
+// (mul, inc) = (1, add) on its own crime and (keep, 0) elsewhere, a
+// straight multiply-add over the padded row that the compiler vectorizes;
+// the reductions keep SCORE_LANES partial sums/maxima for the same reason.
+static double score_kernel(double *restrict s, int num_crimes, const tip_batch_t *t,
+                           int *best_out, double *best_score_out)
+{
+    for (int j = 0; j < t->n; ++j)
+    {
+        double mul[SCORE_WIDTH], inc[SCORE_WIDTH];
+        for (int k = 0; k < SCORE_WIDTH; ++k)
+        {
+            mul[k] = t->keep[j];
+            inc[k] = 0.0;
+        }
+        mul[t->crime[j]] = 1.0;
+        inc[t->crime[j]] = t->add[j];
+        for (int k = 0; k < SCORE_WIDTH; ++k)
+            s[k] = s[k] * mul[k] + inc[k];
+    }
 
-    while (1)
+    double sum[SCORE_LANES] = {0}, max[SCORE_LANES] = {0};
+    for (int k = 0; k < SCORE_WIDTH; k += SCORE_LANES)
+        for (int l = 0; l < SCORE_LANES; ++l)
+        {
+            sum[l] += s[k + l];
+            max[l] = s[k + l] > max[l] ? s[k + l] : max[l];
+        }
+    double total = 0.0, best_score = 0.0;
+    for (int l = 0; l < SCORE_LANES; ++l)
     {
-        ssize_t n = pq_recv(a->pq, &report);
-        if (n == -1)
+        total += sum[l];
+        best_score = max[l] > best_score ? max[l] : best_score;
+    }
+    int best = 0; // first crime holding the maximum (scores are ≥ 0)
+    for (int k = 0; k < num_crimes; ++k)
+        if (s[k] == best_score)
         {
-            if (errno == EINTR)
-                continue;
-            perror("[Police] pq_recv");
+            best = k;
             break;
         }
-        if (n != sizeof(report))
+    *best_out = best;
+    *best_score_out = best_score;
+    return total;
+}
+
+// Score one batch of agent tips against the gang's missions
+static void handle_batch(listen_args_t *a, const Config *cfg, const police_batch_t *batch, int n)
+{
+    shm_layout_t *shm = a->shm;
+    int g = a->gang_id;
+    gang_scores_t *gs = &scores[g];
+    tip_batch_t tips = {.n = 0};
+    int changed = 0;
+
+    if (atomic_exchange_explicit(&gs->reset, 0, memory_order_acquire))
+    {
+        memset(gs->score, 0, sizeof gs->score);
+        changed = 1;
+    }
+
+    for (int i = 0; i < n; ++i)
+    {
+        const police_report_t *report = &batch->reports[i];
+        // 1) Find the crime index
+        if (report->gang_id != g)
         {
-            fprintf(stderr, "[Police] Bad report size %zd (expected %zu)\n",
-                    n, sizeof(report));
+            LOG(LOG_WARN, "[Listener %d] dropped report for Gang %d\n", g, report->gang_id);
             continue;
         }
-
-        // 1) Find the crime index
-        int g = report.gang_id;
-        int m = mission_index(report.mission, shm);
+        int m = mission_index(report->intel);
         if (m < 0)
         {
-            printf("[Listener %d] UNKNOWN snippet: “%s”\n", g, report.mission);
+            LOG(LOG_WARN, "[Listener %d] UNKNOWN intel code: %u\n", g, (unsigned)report->intel);
             continue;
         }
-            // ── bump this crime’s suspicion score by confidence × weight
-    double w = cfg.hint_suspicion_weight[m];
-    if (w <= 0.0) w = 1.0;
-    mission_score[g][m] += report.confidence * w;
+        const char *snippet = intel_text(&shm->cfg, report->intel);
+        double w = cfg->hint_suspicion_weight[m];
+        if (w <= 0.0)
+            w = 1.0;
 
-        ////
         // —— count this hint ——
-        hint_count[g][m] += 1;
+        gs->hint_count[m] += 1;
         // threshold = half the number of legit intel entries (rounded up)
         int needed = (shm->cfg.crimes[m].legit_prep_intel_count + 1) / 2;
-        if (hint_count[g][m] >= needed)
+        if (gs->hint_count[m] >= needed)
         {
             // send immediate full arrest
             police_report_t arrest = {
                 .action = ARREST_ALL,
                 .gang_id = g,
+                .intel = INTEL_CODE(m, 0), // crime travels in the code
                 .confidence = 1.0,
                 .num_to_arrest = shm->cfg.gang_members_max};
-            strncpy(arrest.mission,
-                    shm->cfg.crimes[m].name,
-                    sizeof(arrest.mission) - 1);
-            pq_send(a->pq, &arrest);
-            // reset counters so we don’t re-arrest on future repeats
-            sem_wait(&shm->sem_police);
-            shm->suspicion[g] = 0.0;
-            sem_post(&shm->sem_police);
-            for (int k = 0; k < cfg.num_crimes; ++k)
-                mission_score[g][k] = 0.0;
-            hint_count[g][m] = 0;
-            // skip normal scoring for this report
+            sim_v_post(&shm->clock); // until the referee has acted on it
+            if (ctrl_send(a->out, &arrest, &shm->run_over) == -1)
+            {
+                int e = errno;
+                sim_v_done(&shm->clock);
+                LOG(LOG_WARN, "[Listener %d] arrest order lost: %s\n", g, strerror(e));
+            }
+            // reset counters so we don’t re-arrest on future repeats;
+            // tips before this one no longer matter
+            gang_set_suspicion(shm, g, 0.0);
+            memset(gs->score, 0, sizeof gs->score);
+            tips.n = 0;
+            gs->hint_count[m] = 0;
+            changed = 1;
             continue;
         }
-        printf("\n[Listener %d] snippet \"%s\" → crime[%d]=\"%s\"\n",
-               g, report.mission, m, shm->cfg.crimes[m].name);
+        LOG(LOG_DEBUG, "\n[Listener %d] snippet \"%s\" → crime[%d]=\"%s\"\n",
+                       g, snippet, m, shm->cfg.crimes[m].name);
+        LOG(LOG_INFO, "[Police][Gang %d] tip → \"%s\" (conf=%.2f)\n",
+                      g, snippet, report->confidence);
+
+        // 2) Queue the per-crime update using configured weights: the tip's
+        // crime gains confidence × weight twice (on arrival and when
+        // scored); every other mission is penalized for potential misinformation
+        tips.crime[tips.n] = m;
+        tips.add[tips.n] = 2.0 * report->confidence * w;
+        tips.keep[tips.n] = 1.0 - report->confidence * cfg->misinfo_penalty;
+        tips.n++;
+    }
+    if (tips.n == 0 && !changed)
+        return;
+
+    // 3) Apply the batch, recompute total suspicion and the top mission
+    int best;
+    double best_score;
+    double total = score_kernel(gs->score, cfg->num_crimes, &tips, &best, &best_score);
+    atomic_store_explicit(&gs->best, best, memory_order_relaxed);
+    atomic_store_explicit(&gs->best_score, best_score, memory_order_relaxed);
+    if (tips.n == 0)
+        return;
+    // if nobody’s reported yet, use a tiny epsilon to avoid NaN
+    if (total < 1e-6)
+        total = 1e-6;
+
+    // 4) Write back into shared memory
+    gang_set_suspicion(shm, g, total);
+    brain_notify(g);
+
+    // gui_notify(g, m, "UPDATE_SUSPICION");
+    //  5) Print raw & percentage breakdown
+    if (!LOG_ENABLED(LOG_DEBUG))
+        return;
+    LOG(LOG_DEBUG, " \n\n raw scores:");
+    for (int k = 0; k < cfg->num_crimes; ++k)
+    {
+        LOG(LOG_DEBUG, "\n \"%s\"=%.2f",
+            shm->cfg.crimes[k].name,
+            gs->score[k]);
+    }
+    LOG(LOG_DEBUG, "\n");
 
-        // 2) Update the per-crime score using configured weights
-        //double w = cfg.hint_suspicion_weight[m];
-        if (w <= 0.0)
-            w = 1.0;
-        mission_score[g][m] += report.confidence * w; // penalize other missions for potential misinformation
-        for (int k = 0; k < cfg.num_crimes; ++k)
-        {
-            if (k == m)
-                continue;
-            mission_score[g][k] *=
-                (1.0 - report.confidence * cfg.misinfo_penalty);
-        }
-        // 3) Recompute total suspicion
-        double total = 0.0;
-        for (int k = 0; k < cfg.num_crimes; ++k)
-            total += mission_score[g][k];
-        // if nobody’s reported yet, use a tiny epsilon to avoid NaN
-        if (total < 1e-6)
-            total = 1e-6;
-
-        // 4) Write back into shared memory
-        sem_wait(&shm->sem_police);
-        shm->suspicion[g] = total;
-        sem_post(&shm->sem_police);
-
-        // gui_notify(g, m, "UPDATE_SUSPICION");
-        //  5) Print raw & percentage breakdown
-        printf("[Police][Gang %d] tip → \"%s\" (conf=%.2f)\n",
-               g, report.mission, report.confidence);
-
-        printf(" \n\n raw scores:");
-        for (int k = 0; k < cfg.num_crimes; ++k)
-        {
-            printf("\n \"%s\"=%.2f",
-                   shm->cfg.crimes[k].name,
-                   mission_score[g][k]);
-        }
-        printf("\n");
+    LOG(LOG_DEBUG, "  percentages:");
+    for (int k = 0; k < cfg->num_crimes; ++k)
+    {
+        double pct = gs->score[k] / total * 100.0;
+        LOG(LOG_DEBUG, " \n \"%s\"=%.1f%%",
+            shm->cfg.crimes[k].name,
+            pct);
+    }
+    LOG(LOG_DEBUG, "\n");
+}
 
-        printf("  percentages:");
-        for (int k = 0; k < cfg.num_crimes; ++k)
+static void *listener_thread(void *vp)
+{
+    listen_args_t *a = vp;
+    police_batch_t batch;
+    shm_layout_t *shm = a->shm;
+    Config cfg = shm->cfg;
+
+    LOG(LOG_INFO, "[Listener %d] Thread started, queue=\"%s\"\n",
+                  a->gang_id, a->pq->name);
+
+    while (1)
+    {
+        int n = pq_recv_batch(a->pq, &batch);
+        if (n == -1)
         {
-            double pct = mission_score[g][k] / total * 100.0;
-            printf(" \n \"%s\"=%.1f%%",
-                   shm->cfg.crimes[k].name,
-                   pct);
+            if (errno == EBADMSG)
+            {
+                sim_v_done(&shm->clock); // a frame all the same
+                continue;
+            }
+            if (errno == EINTR)
+                continue;
+            perror("[Police] pq_recv_batch");
+            break;
         }
-        printf("\n");
-
-        fflush(stdout);
+        handle_batch(a, &cfg, &batch, n);
+        sim_v_done(&shm->clock); // the gang's frame is dealt with
     }
 
     pq_close(a->pq);
@@ -179,92 +312,236 @@ static void *listener_thread(void *vp)
 }
 ///////////////////////     MAYS ADDED S     //////////////////////////////
 
+static void timespec_add_ms(struct timespec *ts, long ms)
+{
+    ts->tv_sec += ms / 1000;
+    ts->tv_nsec += (ms % 1000) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L)
+    {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+static int timespec_before(const struct timespec *a, const struct timespec *b)
+{
+    return a->tv_sec < b->tv_sec || (a->tv_sec == b->tv_sec && a->tv_nsec < b->tv_nsec);
+}
+
+// ───── Jail timer wheel ─────
+// WHEEL_SLOTS buckets of WHEEL_TICK_MS each; a term longer than one turn
+// of the wheel waits out `rounds` extra turns in its bucket. Each gang
+// has at most one term running, so its timer is preallocated.
+#define WHEEL_SLOTS 64
+#define WHEEL_TICK_MS 100
+
+typedef struct jail_timer
+{
+    struct jail_timer *next;
+    int gang;
+    unsigned rounds;
+} jail_timer_t;
+
+typedef struct
+{
+    jail_timer_t *slot[WHEEL_SLOTS];
+    unsigned cursor;
+    int pending;
+    struct timespec next_tick; // valid while pending > 0
+} timer_wheel_t;
+
+static void wheel_add(timer_wheel_t *w, jail_timer_t *t, long delay_ms, const struct timespec *now)
+{
+    long ticks = (delay_ms + WHEEL_TICK_MS - 1) / WHEEL_TICK_MS;
+    if (ticks < 1)
+        ticks = 1;
+    unsigned idx = (w->cursor + ticks) % WHEEL_SLOTS;
+    t->rounds = (ticks - 1) / WHEEL_SLOTS;
+    t->next = w->slot[idx];
+    w->slot[idx] = t;
+    if (w->pending++ == 0)
+    {
+        w->next_tick = *now;
+        timespec_add_ms(&w->next_tick, WHEEL_TICK_MS);
+    }
+}
+
+// Move one tick; expired timers are unlinked and returned as a list
+static jail_timer_t *wheel_advance(timer_wheel_t *w)
+{
+    jail_timer_t *expired = NULL;
+    w->cursor = (w->cursor + 1) % WHEEL_SLOTS;
+    for (jail_timer_t **pp = &w->slot[w->cursor]; *pp;)
+    {
+        jail_timer_t *t = *pp;
+        if (t->rounds > 0)
+        {
+            t->rounds--;
+            pp = &t->next;
+            continue;
+        }
+        *pp = t->next;
+        t->next = expired;
+        expired = t;
+        w->pending--;
+    }
+    timespec_add_ms(&w->next_tick, WHEEL_TICK_MS);
+    return expired;
+}
+
+static void brain_unlock(void *mtx)
+{
+    pthread_mutex_unlock(mtx);
+}
+
+// Virtual time: hold the clock until the gang's process has taken the
+// arrest (its SIGUSR1 handler bumps arrests_taken), so its members freeze
+// at the instant the brain decided. Bounded, in case the process is gone.
+static void brain_await_arrest(shm_layout_t *shm, int g, uint32_t taken)
+{
+    const struct timespec nap = {.tv_sec = 0, .tv_nsec = 100000L};
+    for (int i = 0; i < 10000 && SHM_LOAD(&shm->per_gang[g].arrests_taken) == taken; i++)
+        nanosleep(&nap, NULL);
+}
+
+// off the virtual clock for good (no-op on a wall-scaled one)
+static void brain_leave_clock(void)
+{
+    pthread_mutex_lock(&brain_ev.mtx);
+    if (brain_ev.party >= 0)
+        sim_v_leave(brain_ev.clock, brain_ev.party);
+    brain_ev.party = -1;
+    pthread_mutex_unlock(&brain_ev.mtx);
+}
+
 static void *brain_thread(void *vp)
 {
     shm_layout_t *shm = vp;
     Config        cfg = shm->cfg;
+    static jail_timer_t jail[MAX_GANGS];
+    static int jailed[MAX_GANGS];
+    timer_wheel_t wheel = {0};
+
+    // HQ counted the brain as the police's party on a virtual clock
+    if (shm->clock.virtual_time) {
+        pthread_mutex_lock(&brain_ev.mtx);
+        brain_ev.clock = &shm->clock;
+        brain_ev.party = sim_v_join(&shm->clock, 0);
+        pthread_mutex_unlock(&brain_ev.mtx);
+    }
 
-    // open the same queue you use for THWART
+    // orders go to the referee on the control channel
     police_queue_t pq;
-    if (pq_open(&pq, POLICE_QUEUE_NAME) < 0) {
+    if (pq_open(&pq, CTRL_QUEUE_NAME) < 0) {
         perror("brain: pq_open (write)");
+        brain_leave_clock();
         return NULL;
     }
 
+    long status_ms = cfg.status_update_interval_s > 0 ? cfg.status_update_interval_s * 1000L : 1000;
+    // status intervals and jail terms run on the shared simulated clock
+    struct timespec now, next_status;
+    sim_now(&shm->clock, &now);
+    next_status = now;
+    timespec_add_ms(&next_status, status_ms);
+
     while (1) {
         // optional shutdown
-        sem_wait(&shm->sem_score);
-        if (shm->score.plans_thwarted >= cfg.max_thwarted_plans) {
-            sem_post(&shm->sem_score);
-            printf("[Brain] reached max_thwarted_plans=%d, exiting\n",
-                   cfg.max_thwarted_plans);
+        if (score_get_plans_thwarted(shm) >= (uint32_t)cfg.max_thwarted_plans) {
+            LOG(LOG_INFO, "[Brain] reached max_thwarted_plans=%d, exiting\n",
+                          cfg.max_thwarted_plans);
             break;
         }
-        sem_post(&shm->sem_score);
 
-        usleep(shm->cfg.status_update_interval_s * 1000000);
-        printf("[Brain] evaluating gangs…\n");
+        // sleep until a listener reports, a term ends or a status is due
+        struct timespec deadline = next_status;
+        if (wheel.pending && timespec_before(&wheel.next_tick, &deadline))
+            deadline = wheel.next_tick;
+        uint64_t dirty[(MAX_GANGS + 63) / 64];
+        pthread_mutex_lock(&brain_ev.mtx);
+        pthread_cleanup_push(brain_unlock, &brain_ev.mtx);
+        if (brain_ev.party >= 0) {
+            // virtual time: the keeper wakes us at the deadline, a listener before it
+            if (!brain_ev.any) {
+                uint32_t seen = sim_v_idle(&shm->clock, brain_ev.party, sim_v_due(&shm->clock, &deadline));
+                pthread_mutex_unlock(&brain_ev.mtx);
+                sim_v_wait(&shm->clock, brain_ev.party, seen);
+                pthread_mutex_lock(&brain_ev.mtx);
+            }
+        } else {
+            sim_to_real(&shm->clock, &deadline, &deadline);
+            while (!brain_ev.any &&
+                   pthread_cond_timedwait(&brain_ev.cond, &brain_ev.mtx, &deadline) != ETIMEDOUT)
+                ;
+        }
+        memcpy(dirty, brain_ev.dirty, sizeof dirty);
+        memset(brain_ev.dirty, 0, sizeof brain_ev.dirty);
+        brain_ev.any = 0;
+        pthread_cleanup_pop(1);
+        sim_now(&shm->clock, &now);
+
+        // jail terms that ran out
+        while (wheel.pending && !timespec_before(&now, &wheel.next_tick)) {
+            for (jail_timer_t *t = wheel_advance(&wheel); t; t = t->next) {
+                int g = t->gang;
+                LOG(LOG_INFO, "🔓 Gang[%d] released from jail, resuming operations.\n",
+                              g);
+                // reset local and shared suspicion; the gang's listener
+                // clears its scores before it takes the next report
+                gang_set_released(shm, g);
+                atomic_store_explicit(&scores[g].reset, 1, memory_order_release);
+                jailed[g] = 0;
 
-        // just logging suspicion
-        for (int g = 0; g < cfg.num_gangs; ++g) {
-            sem_wait(&shm->sem_police);
-            double s = shm->suspicion[g];
-            sem_post(&shm->sem_police);
-
-            // find top mission index
-            int best = 0;
-            double best_score = mission_score[g][0];
-            for (int k = 1; k < cfg.num_crimes; ++k) {
-                if (mission_score[g][k] > best_score) {
-                    best_score = mission_score[g][k];
-                    best = k;
-                }
+                // bump thwarted count
+                score_inc_plans_thwarted(shm);
+            }
+        }
+
+        // periodic status: log every gang and re-evaluate all of them
+        if (!timespec_before(&now, &next_status)) {
+            LOG(LOG_INFO, "[Brain] evaluating gangs…\n");
+            for (int g = 0; g < cfg.num_gangs; ++g) {
+                double s = gang_get_suspicion(shm, g);
+
+                // top mission index, as maintained by the gang's listener
+                int best = atomic_load_explicit(&scores[g].best, memory_order_relaxed);
+                double best_score = atomic_load_explicit(&scores[g].best_score, memory_order_relaxed);
+                LOG(LOG_INFO, "[Brain] Gang %d: suspicion=%.2f → \"%s\" (%.2f)\n",
+                              g, s, shm->cfg.crimes[best].name, best_score);
+                dirty[g / 64] |= 1ull << (g % 64);
             }
-            printf("[Brain] Gang %d: suspicion=%.2f → \"%s\" (%.2f)\n",
-                   g, s, shm->cfg.crimes[best].name, best_score);
+            while (!timespec_before(&now, &next_status))
+                timespec_add_ms(&next_status, status_ms);
         }
 
-        // decide THWART vs ARREST
+        // decide THWART vs ARREST for the gangs that changed
         for (int g = 0; g < cfg.num_gangs; ++g) {
-            sem_wait(&shm->sem_police);
-            double s = shm->suspicion[g];
-            sem_post(&shm->sem_police);
-          int sentence = shm->gang[g].prison_sentence_duration;
+            if (!(dirty[g / 64] & (1ull << (g % 64))) || jailed[g])
+                continue;
+            gang_snapshot_t snap;
+            gang_snapshot(shm, g, &snap, 0); // suspicion + sentence, no member tables
+            double s = snap.suspicion;
+            // no per-gang sentence set → the configured one
+            int sentence = snap.prison_sentence_duration ? snap.prison_sentence_duration
+                                                         : cfg.prison_sentence_duration;
 
             if (s >= 0.2) {
                 // — ARREST via SIGUSR1 —
-                pid_t pid = shm->gang_pids[g];
+                pid_t pid = shm->per_gang[g].pid;
                 if (pid > 0) {
-                    printf("🚨 Gang[%d] has been arrested! Holding for few seconds\n ,SIGUSR1 to Gang[%d] (pid=%d)\n", g, pid);
-                    kill(pid, SIGUSR1);
-                    sem_wait(&shm->sem_police);
-                    shm->gang[g].jailed = 1;
-                    sem_post(&shm->sem_police);
-                    fflush(stdout);
-
+                    LOG(LOG_INFO, "🚨 Gang[%d] has been arrested! Holding for %d s\n ,SIGUSR1 to Gang[%d] (pid=%d)\n",
+                                  g, sentence, g, pid);
+                    // one process may host several gangs: tell it which one
+                    uint32_t taken = SHM_LOAD(&shm->per_gang[g].arrests_taken);
+                    if (sigqueue(pid, SIGUSR1, (union sigval){.sival_int = g}) == 0 &&
+                        shm->clock.virtual_time)
+                        brain_await_arrest(shm, g, taken);
+                    gang_set_jailed(shm, g, 1);
                 }
-                
-            fflush(stdout);
-
-            // simulate jail time
-            sleep(sentence);
-
-            printf("🔓 Gang[%d] released from jail, resuming operations.\n",
-                   g);
-                // reset local and shared suspicion
-                sem_wait(&shm->sem_police);
-                  shm->gang[g].jailed = 0;
-                  shm->suspicion[g] = 0.0;
-                sem_post(&shm->sem_police);
-                for (int k = 0; k < cfg.num_crimes; ++k)
-                    mission_score[g][k] = 0.0;
-
-                // bump thwarted count
-                sem_wait(&shm->sem_score);
-                  shm->score.plans_thwarted++;
-                sem_post(&shm->sem_score);
-                            fflush(stdout);
-
+                // jail time runs on the wheel; other gangs keep being watched
+                jailed[g] = 1;
+                jail[g].gang = g;
+                wheel_add(&wheel, &jail[g], sentence * 1000L, &now);
             }
             else if (s >= cfg.police_confirmation_threshold) {
                 // — THWART via queue —
@@ -274,21 +551,36 @@ static void *brain_thread(void *vp)
                   .confidence    = 0.0,
                   .num_to_arrest = 1
                 };
-                pq_send(&pq, &rpt);
+                sim_v_post(&shm->clock); // until the referee has acted on it
+                if (ctrl_send(&pq, &rpt, &shm->run_over) == -1) {
+                    int e = errno;
+                    sim_v_done(&shm->clock);
+                    LOG(LOG_WARN, "[Police] thwart order for Gang %d lost: %s\n", g, strerror(e));
+                }
 
-                sem_wait(&shm->sem_police);
-                  shm->suspicion[g] *= cfg.agent_knowledge_decay_rate;
-                sem_post(&shm->sem_police);
+                gang_scale_suspicion(shm, g, cfg.agent_knowledge_decay_rate);
             }
         }
     }
 
+    brain_leave_clock();
     pq_close(&pq);
     return NULL;
 }
 
 ///////////////////////     MAYS ADDED E     //////////////////////////////
 
+// HQ ends the run with SIGTERM. It is blocked everywhere and taken here,
+// so the buffered log reaches stdout before the process goes.
+static void *term_thread(void *arg)
+{
+    sigset_t *term = arg;
+    int signo;
+    sigwait(term, &signo);
+    log_flush();
+    _exit(EXIT_SUCCESS);
+}
+
 int main(int argc, char *argv[])
 {
     ///////////////////////     MAYS ADDED fri s     //////////////////////////////
@@ -311,6 +603,18 @@ int main(int argc, char *argv[])
         return EXIT_FAILURE;
     }
     fprintf(stderr, "[Police] attached shared memory at %p\n", (void *)shm);
+    // before the first thread (the log flusher), so every thread inherits it
+    static sigset_t term;
+    sigemptyset(&term);
+    sigaddset(&term, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &term, NULL);
+    log_init(shm->cfg.logging_verbosity);
+    pthread_t term_thr;
+    if (pthread_create(&term_thr, NULL, term_thread, &term) != 0)
+    {
+        perror("[Police] pthread_create term");
+        return EXIT_FAILURE;
+    }
 
     // Read config from shared memory
     Config cfg = shm->cfg;
@@ -320,39 +624,51 @@ int main(int argc, char *argv[])
             cfg.hint_suspicion_weight[i] = 1.0;
 
     fprintf(stderr, "[Police] cfg.num_gangs = %d\n", cfg.num_gangs);
+    build_crime_lookup(&shm->cfg);
+
+    brain_events_init();
 
-    // Open the shared queue for receiving
-    police_queue_t shared_pq;
-    if (pq_open_read(&shared_pq, POLICE_QUEUE_NAME) < 0)
+    // Orders for the referee (listener arrests) go out on the control channel
+    police_queue_t referee_pq;
+    if (pq_open(&referee_pq, CTRL_QUEUE_NAME) < 0)
     {
-        fprintf(stderr, "[Police] pq_open_read failed: %s\n",
-                strerror(errno));
+        fprintf(stderr, "[Police] pq_open failed: %s\n", strerror(errno));
         return EXIT_FAILURE;
     }
-    fprintf(stderr, "[Police] pq_open_read succeeded: name=\"%s\" mq=%d buf=%zu\n",
-            shared_pq.name,
-            (int)shared_pq.mq,
-            shared_pq.msg_size);
 
-    // Spawn listener threads
+    // One listener per gang, each draining that gang's own ingest queue
     pthread_t thr[cfg.num_gangs];
     listen_args_t args[cfg.num_gangs];
+    police_queue_t ingest[cfg.num_gangs];
 
     for (int i = 0; i < cfg.num_gangs; ++i)
     {
-        args[i].pq = &shared_pq;
+        char name[64];
+        police_ingest_name(name, sizeof name, i);
+        if (pq_open_read(&ingest[i], name) < 0)
+        {
+            fprintf(stderr, "[Police] pq_open_read %s failed: %s\n",
+                    name, strerror(errno));
+            return EXIT_FAILURE;
+        }
+        fprintf(stderr, "[Police] pq_open_read succeeded: name=\"%s\" mq=%d buf=%zu\n",
+                ingest[i].name,
+                (int)ingest[i].mq,
+                ingest[i].msg_size);
+
+        args[i].pq = &ingest[i];
+        args[i].out = &referee_pq;
         args[i].gang_id = i;
         args[i].shm = shm;
 
         if (pthread_create(&thr[i], NULL, listener_thread, &args[i]) != 0)
         {
             perror("[Police] pthread_create");
-            pq_close(&shared_pq);
             return EXIT_FAILURE;
         }
     }
     ////////////////////////    ADDED MAYS S       ////////////////////
-    // after you've opened shared_pq and spawned listeners:
+    // after you've opened the queues and spawned listeners:
     pthread_t brain_thr;
     if (pthread_create(&brain_thr, NULL, brain_thread, shm) != 0)
     {
@@ -369,8 +685,8 @@ int main(int argc, char *argv[])
     }
     pthread_cancel(brain_thr);
     pthread_join(brain_thr, NULL);
-    // Cleanup
-    pq_close(&shared_pq);
+    // Cleanup (each listener closed its own ingest queue)
+    pq_close(&referee_pq);
 
     return 0;
 }
@@ -0,0 +1,61 @@
+/* file: rng.h */
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+// ───────────── Per-thread PRNG streams ─────────────
+// xoshiro256** with splitmix64 seeding. Every gang, leader and member
+// owns an rng_t seeded from (cfg.random_seed, gang, member), so streams
+// are independent, lock-free (unlike rand()) and reproducible for a
+// given seed no matter which thread or worker runs the member.
+
+typedef struct {
+    uint64_t s[4];
+} rng_t;
+
+#define RNG_GANG_STREAM (-1)   // member id for a gang's own stream
+
+static inline uint64_t rng_splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+static inline void rng_seed(rng_t *r, uint64_t seed, int gang_id, int member_id) {
+    uint64_t x = seed;
+    uint64_t mixed = rng_splitmix64(&x); // advances x; xor into it afterwards
+    x ^= mixed ^ ((uint64_t)(uint32_t)gang_id << 32 | (uint32_t)member_id);
+    for (int i = 0; i < 4; ++i)
+        r->s[i] = rng_splitmix64(&x);
+}
+
+static inline uint64_t rng_rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+static inline uint64_t rng_next(rng_t *r) {
+    uint64_t *s = r->s;
+    uint64_t result = rng_rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rng_rotl(s[3], 45);
+    return result;
+}
+
+// uniform in [0, 1)
+static inline double rng_unit(rng_t *r) {
+    return (rng_next(r) >> 11) * 0x1.0p-53;
+}
+
+// uniform in [0, n) for n > 0
+static inline int rng_below(rng_t *r, int n) {
+    return (int)(((rng_next(r) >> 32) * (uint64_t)n) >> 32);
+}
+
+#endif // RNG_H
@@ -0,0 +1,262 @@
+/* file: simclock.h */
+#ifndef SIMCLOCK_H
+#define SIMCLOCK_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include <limits.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+// ───────────── Shared simulation clock ─────────────
+// HQ starts one sim_clock_t in shared memory before any child exists;
+// from then on every process derives simulated time from the same epoch
+// and cfg.time_scale (simulated seconds per wall-clock second), so
+// gangs, police and referee stay in lockstep however far the run is
+// accelerated. Simulated CLOCK_MONOTONIC deadlines go through
+// sim_to_real() before they reach pthread_cond_timedwait(). A NULL clock
+// or a scale of 1 is plain wall-clock time.
+//
+// With clock_mode "virtual" (sim_v_start) the clock is not tied to the
+// wall at all: simulated time is `vnow`, and it only moves once every
+// party is idle. A party is whatever owns timers — each gang process's
+// executor, the police brain. `busy` counts the parties that are running
+// plus the messages in flight between processes (report frames, referee
+// orders), so time cannot jump past an event someone is about to cause.
+// HQ's keeper (sim_v_keep) waits for busy to reach 0, moves vnow to the
+// earliest due and wakes every party due by then.
+
+#define SIM_MAX_PARTIES 128
+#define SIM_NEVER       INT64_MAX  // idle with nothing scheduled
+#define SIM_RUNNING     (-1)       // sim_party_t.due while the party runs
+#define SIM_LEFT        (-2)       // ... and once it has left the clock
+
+typedef struct {
+    _Atomic int64_t  due;         // vnow to be woken at, or SIM_RUNNING / SIM_LEFT
+    _Atomic uint32_t wake;        // futex word, bumped whenever the party is woken
+    int              active;      // gangs are; time stops once no active party is left
+} sim_party_t;
+
+typedef struct {
+    struct timespec epoch_mono;   // CLOCK_MONOTONIC when the clock started
+    struct timespec epoch_real;   // CLOCK_REALTIME at the same instant
+    double          scale;        // simulated seconds per real second (> 0)
+    int             virtual_time; // clock_mode "virtual": time is vnow
+    _Atomic int64_t  vnow;        // virtual: simulated ns since the epoch
+    _Atomic uint32_t busy;        // virtual: running parties + messages in flight
+    _Atomic int      nparties, nactive;
+    sim_party_t      party[SIM_MAX_PARTIES];
+} sim_clock_t;
+
+static inline int64_t sim_ts_ns(const struct timespec *ts) {
+    return (int64_t)ts->tv_sec * 1000000000LL + ts->tv_nsec;
+}
+
+static inline struct timespec sim_ns_ts(int64_t ns) {
+    struct timespec ts = { .tv_sec = ns / 1000000000LL, .tv_nsec = ns % 1000000000LL };
+    return ts;
+}
+
+static inline void sim_clock_start(sim_clock_t *c, double scale) {
+    clock_gettime(CLOCK_MONOTONIC, &c->epoch_mono);
+    clock_gettime(CLOCK_REALTIME, &c->epoch_real);
+    c->scale = scale > 0 ? scale : 1.0;
+}
+
+// simulated time elapsed since the epoch, in ns
+static inline int64_t sim_elapsed_ns(const sim_clock_t *c) {
+    if (c->virtual_time)
+        return atomic_load(&c->vnow);
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)((sim_ts_ns(&now) - sim_ts_ns(&c->epoch_mono)) * c->scale);
+}
+
+// simulated CLOCK_MONOTONIC
+static inline void sim_now(const sim_clock_t *c, struct timespec *ts) {
+    if (!c || (c->scale == 1.0 && !c->virtual_time)) {
+        clock_gettime(CLOCK_MONOTONIC, ts);
+        return;
+    }
+    *ts = sim_ns_ts(sim_ts_ns(&c->epoch_mono) + sim_elapsed_ns(c));
+}
+
+// simulated CLOCK_REALTIME, in ns (for event stamps)
+static inline int64_t sim_realtime_ns(const sim_clock_t *c) {
+    if (!c || (c->scale == 1.0 && !c->virtual_time)) {
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        return sim_ts_ns(&now);
+    }
+    return sim_ts_ns(&c->epoch_real) + sim_elapsed_ns(c);
+}
+
+// simulated time(NULL)
+static inline time_t sim_time(const sim_clock_t *c) {
+    return (time_t)(sim_realtime_ns(c) / 1000000000LL);
+}
+
+// a simulated CLOCK_MONOTONIC deadline as a real one (not in virtual
+// time: parties wait with sim_v_idle() there)
+static inline void sim_to_real(const sim_clock_t *c, const struct timespec *sim, struct timespec *real) {
+    if (!c || c->scale == 1.0) {
+        *real = *sim;
+        return;
+    }
+    int64_t epoch = sim_ts_ns(&c->epoch_mono);
+    *real = sim_ns_ts(epoch + (int64_t)((sim_ts_ns(sim) - epoch) / c->scale));
+}
+
+// sleep for `us` simulated microseconds; signals do not cut it short.
+// Wall-scaled clocks only, like sim_to_real().
+static inline void sim_usleep(const sim_clock_t *c, long us) {
+    double scale = c && c->scale > 0 ? c->scale : 1.0;
+    struct timespec until;
+    clock_gettime(CLOCK_MONOTONIC, &until);
+    until = sim_ns_ts(sim_ts_ns(&until) + (int64_t)(us * 1000.0 / scale));
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL) == EINTR)
+        ;
+}
+
+static inline void sim_sleep(const sim_clock_t *c, unsigned seconds) {
+    sim_usleep(c, seconds * 1000000L);
+}
+
+// ───────────── Virtual time ─────────────
+static inline long sim_futex(_Atomic uint32_t *addr, int op, uint32_t val, const struct timespec *ts) {
+    return syscall(SYS_futex, (uint32_t *)addr, op, val, ts, NULL, 0);
+}
+
+// HQ, before any child exists: `parties` will join, each counted busy
+// from now until it first goes idle
+static inline void sim_v_start(sim_clock_t *c, int parties) {
+    c->virtual_time = 1;
+    atomic_store(&c->vnow, 0);
+    atomic_store(&c->nparties, 0);
+    atomic_store(&c->nactive, 0);
+    for (int i = 0; i < SIM_MAX_PARTIES; i++)
+        atomic_store(&c->party[i].due, SIM_LEFT);
+    atomic_store(&c->busy, (uint32_t)parties);
+}
+
+// a simulated CLOCK_MONOTONIC instant as a due for sim_v_idle()
+static inline int64_t sim_v_due(const sim_clock_t *c, const struct timespec *sim) {
+    return sim_ts_ns(sim) - sim_ts_ns(&c->epoch_mono);
+}
+
+// one of the parties HQ counted joins, running; returns its slot
+static inline int sim_v_join(sim_clock_t *c, int active) {
+    int id = atomic_fetch_add(&c->nparties, 1);
+    c->party[id].active = active;
+    if (active)
+        atomic_fetch_add(&c->nactive, 1);
+    atomic_store(&c->party[id].due, SIM_RUNNING);
+    return id;
+}
+
+static inline void sim_v_unbusy(sim_clock_t *c) {
+    if (atomic_fetch_sub(&c->busy, 1) == 1)
+        sim_futex(&c->busy, FUTEX_WAKE, 1, NULL);
+}
+
+// A message to another process is in flight from sim_v_post() on the
+// sender until sim_v_done() on the receiver, once it has acted on it.
+// Both are no-ops on a wall-scaled clock.
+static inline void sim_v_post(sim_clock_t *c) {
+    if (c->virtual_time)
+        atomic_fetch_add(&c->busy, 1);
+}
+
+static inline void sim_v_done(sim_clock_t *c) {
+    if (c->virtual_time)
+        sim_v_unbusy(c);
+}
+
+// Party `id` has nothing to do before vnow reaches `due` (SIM_NEVER: until
+// someone resumes it). Pass the result to sim_v_wait().
+static inline uint32_t sim_v_idle(sim_clock_t *c, int id, int64_t due) {
+    uint32_t seen = atomic_load(&c->party[id].wake);
+    atomic_store(&c->party[id].due, due < 0 ? 0 : due);
+    sim_v_unbusy(c);
+    return seen;
+}
+
+// until the keeper or sim_v_resume() wakes the party (or sim_v_kick())
+static inline void sim_v_wait(sim_clock_t *c, int id, uint32_t seen) {
+    while (atomic_load(&c->party[id].wake) == seen)
+        sim_futex(&c->party[id].wake, FUTEX_WAIT, seen, NULL);
+}
+
+static inline void sim_v_kick(sim_clock_t *c, int id) {
+    atomic_fetch_add(&c->party[id].wake, 1);
+    sim_futex(&c->party[id].wake, FUTEX_WAKE, INT_MAX, NULL);
+}
+
+// idle (due ≥ 0) → running, counted busy before it wakes
+static inline int sim_v_claim(sim_clock_t *c, int id, int64_t due) {
+    if (due < 0 || !atomic_compare_exchange_strong(&c->party[id].due, &due, SIM_RUNNING))
+        return 0;
+    atomic_fetch_add(&c->busy, 1);
+    sim_v_kick(c, id);
+    return 1;
+}
+
+// Wake party `id` now if it is idle. The caller must itself be busy (a
+// running party or a message being handled), so vnow stays put.
+static inline int sim_v_resume(sim_clock_t *c, int id) {
+    return sim_v_claim(c, id, atomic_load(&c->party[id].due));
+}
+
+// for good, running or idle
+static inline void sim_v_leave(sim_clock_t *c, int id) {
+    int64_t due = atomic_load(&c->party[id].due);
+    while (!atomic_compare_exchange_weak(&c->party[id].due, &due, SIM_LEFT))
+        ;
+    if (c->party[id].active)
+        atomic_fetch_sub(&c->nactive, 1);
+    if (due == SIM_RUNNING)
+        sim_v_unbusy(c);
+    else
+        sim_futex(&c->busy, FUTEX_WAKE, 1, NULL);
+}
+
+// HQ's keeper. Returns 0 once the next event lies past `limit_ns` (vnow
+// is then the limit), -1 once *stop is set.
+static inline int sim_v_keep(sim_clock_t *c, const _Atomic int *stop, int64_t limit_ns) {
+    const struct timespec nap = { .tv_sec = 0, .tv_nsec = 100000000L }; // to notice *stop
+    while (!atomic_load(stop)) {
+        uint32_t busy = atomic_load(&c->busy);
+        if (busy != 0 || atomic_load(&c->nactive) == 0) {
+            sim_futex(&c->busy, FUTEX_WAIT, busy, &nap);
+            continue;
+        }
+        int n = atomic_load(&c->nparties);
+        int64_t now = atomic_load(&c->vnow), next = SIM_NEVER;
+        for (int i = 0; i < n; i++) {
+            int64_t due = atomic_load(&c->party[i].due);
+            if (due >= 0 && due < next)
+                next = due;
+        }
+        if (next == SIM_NEVER) {
+            sim_futex(&c->busy, FUTEX_WAIT, 0, &nap);
+            continue;
+        }
+        if (next > limit_ns) {
+            atomic_store(&c->vnow, limit_ns > now ? limit_ns : now);
+            return 0;
+        }
+        if (next > now)
+            atomic_store(&c->vnow, now = next);
+        for (int i = 0; i < n; i++) {
+            int64_t due = atomic_load(&c->party[i].due);
+            if (due >= 0 && due <= now)
+                sim_v_claim(c, i, due);
+        }
+    }
+    return -1;
+}
+
+#endif // SIMCLOCK_H